@@ -39,6 +39,7 @@ public class EnhancedTick : ModuleRules
 				"Engine",
 				"Slate",
 				"SlateCore",
+				"TraceLog",
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
@@ -0,0 +1,417 @@
+// Copyright (C) Thyke 2025 All Rights Reserved.
+
+#include "EnhancedTickBenchmarkCommandlet.h"
+#include "EnhancedTickSystem.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/WorldSettings.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "Components/BoxComponent.h"
+#include "AIController.h"
+#include "Perception/AIPerceptionComponent.h"
+#include "Perception/AISenseConfig_Sight.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/UObjectGlobals.h"
+
+// Spacing of the spawned population on the ground plane (world units)
+#define ENHANCED_TICK_BENCHMARK_SPACING 200.0f
+
+// Height of the floor the characters walk on
+#define ENHANCED_TICK_BENCHMARK_FLOOR_Z 0.0f
+
+//////////////////////////////////////////////////////////////////////////
+// UEnhancedTickBenchmarkComponent Implementation
+
+UEnhancedTickBenchmarkComponent::UEnhancedTickBenchmarkComponent()
+    : Phase(0.0f)
+    , Value(0.0f)
+{
+    PrimaryComponentTick.bCanEverTick = true;
+}
+
+void UEnhancedTickBenchmarkComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+    // Only touches its own state, so the batch is safe to tick in parallel
+    Phase = FMath::Fmod(Phase + DeltaTime * 3.0f, 2.0f * PI);
+    Value = FMath::Sin(Phase) * 0.5f + Value * 0.5f;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Benchmark helpers
+
+enum class EEnhancedTickBenchmarkMode : uint8
+{
+    Native,
+    Serial,
+    Parallel,
+};
+
+static const TCHAR* GetBenchmarkModeName(EEnhancedTickBenchmarkMode Mode)
+{
+    switch (Mode)
+    {
+    case EEnhancedTickBenchmarkMode::Native:    return TEXT("Native");
+    case EEnhancedTickBenchmarkMode::Serial:    return TEXT("Serial");
+    case EEnhancedTickBenchmarkMode::Parallel:  return TEXT("Parallel");
+    }
+    return TEXT("Unknown");
+}
+
+// Options shared by every run
+struct FEnhancedTickBenchmarkOptions
+{
+    int32 Frames;
+    int32 WarmupFrames;
+    float DeltaTime;
+    float MovingFraction;
+    
+    FEnhancedTickBenchmarkOptions() : Frames(300), WarmupFrames(30), DeltaTime(1.0f / 30.0f), MovingFraction(0.5f) {}
+};
+
+// Measurements of one scenario, population and mode
+struct FEnhancedTickBenchmarkRun
+{
+    FString Scenario;
+    int32 Count;
+    EEnhancedTickBenchmarkMode Mode;
+    TArray<float> FrameTimesMs;
+    TArray<FEnhancedTickBatchStats> BatchStats;
+    
+    FEnhancedTickBenchmarkRun() : Count(0), Mode(EEnhancedTickBenchmarkMode::Native) {}
+};
+
+// Comma separated option, with a default when it is not given
+static TArray<FString> ParseListOption(const FString& Params, const TCHAR* Name, const TCHAR* Default)
+{
+    FString Value;
+    if (!FParse::Value(*Params, Name, Value, false))
+    {
+        Value = Default;
+    }
+    
+    TArray<FString> Items;
+    Value.ParseIntoArray(Items, TEXT(","), true);
+    for (FString& Item : Items)
+    {
+        Item.TrimStartAndEndInline();
+    }
+    return Items;
+}
+
+// Nearest-rank percentile of sorted values
+static float GetSortedPercentile(const TArray<float>& Sorted, float Fraction)
+{
+    if (Sorted.Num() == 0)
+    {
+        return 0.0f;
+    }
+    return Sorted[FMath::Clamp(FMath::CeilToInt(Fraction * Sorted.Num()) - 1, 0, Sorted.Num() - 1)];
+}
+
+// Grid position of the n-th member of a population
+static FVector GetBenchmarkSpawnLocation(int32 Index, int32 Count, float Height)
+{
+    const int32 Side = FMath::Max(1, FMath::CeilToInt(FMath::Sqrt(float(Count))));
+    return FVector((Index % Side) * ENHANCED_TICK_BENCHMARK_SPACING, (Index / Side) * ENHANCED_TICK_BENCHMARK_SPACING, Height);
+}
+
+// Large blocking box under the population, so characters walk instead of falling forever
+static void SpawnBenchmarkFloor(UWorld* World, int32 Count)
+{
+    AActor* Floor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity);
+    UBoxComponent* Box = NewObject<UBoxComponent>(Floor, TEXT("Floor"));
+    
+    const float HalfExtent = FMath::CeilToFloat(FMath::Sqrt(float(Count))) * ENHANCED_TICK_BENCHMARK_SPACING * 0.5f + 1000.0f;
+    Box->SetBoxExtent(FVector(HalfExtent, HalfExtent, 50.0f));
+    Box->SetCollisionProfileName(TEXT("BlockAll"));
+    Floor->SetRootComponent(Box);
+    Box->RegisterComponent();
+    Floor->SetActorLocation(FVector(HalfExtent - 1000.0f, HalfExtent - 1000.0f, ENHANCED_TICK_BENCHMARK_FLOOR_Z - 50.0f));
+}
+
+// Spawn a population and collect the components that the enhanced modes register
+static bool SpawnBenchmarkPopulation(UWorld* World, const FString& Scenario, int32 Count, TArray<UActorComponent*>& OutComponents, TArray<ACharacter*>& OutCharacters)
+{
+    FActorSpawnParameters SpawnParams;
+    SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+    
+    if (Scenario == TEXT("CMC"))
+    {
+        SpawnBenchmarkFloor(World, Count);
+    
+        for (int32 Index = 0; Index < Count; ++Index)
+        {
+            const FVector Location = GetBenchmarkSpawnLocation(Index, Count, ENHANCED_TICK_BENCHMARK_FLOOR_Z + 100.0f);
+            ACharacter* Character = World->SpawnActor<ACharacter>(ACharacter::StaticClass(), Location, FRotator::ZeroRotator, SpawnParams);
+            if (!Character)
+            {
+                continue;
+            }
+    
+            // No controllers are spawned; the benchmark feeds the input itself
+            UCharacterMovementComponent* Movement = Character->GetCharacterMovement();
+            Movement->bRunPhysicsWithNoController = true;
+            Movement->SetMovementMode(MOVE_Walking);
+    
+            OutCharacters.Add(Character);
+            OutComponents.Add(Movement);
+        }
+        return true;
+    }
+    
+    if (Scenario == TEXT("Perception"))
+    {
+        for (int32 Index = 0; Index < Count; ++Index)
+        {
+            const FVector Location = GetBenchmarkSpawnLocation(Index, Count, 100.0f);
+            AAIController* Controller = World->SpawnActor<AAIController>(AAIController::StaticClass(), Location, FRotator::ZeroRotator, SpawnParams);
+            if (!Controller)
+            {
+                continue;
+            }
+    
+            UAIPerceptionComponent* Perception = NewObject<UAIPerceptionComponent>(Controller, TEXT("Perception"));
+            UAISenseConfig_Sight* SightConfig = NewObject<UAISenseConfig_Sight>(Perception);
+            SightConfig->SightRadius = 2000.0f;
+            SightConfig->LoseSightRadius = 2500.0f;
+            SightConfig->DetectionByAffiliation.bDetectNeutrals = true;
+            Perception->ConfigureSense(*SightConfig);
+            Perception->SetDominantSense(SightConfig->GetSenseImplementation());
+    
+            // Perception components only tick when asked to; ticking them is what is being compared
+            Perception->PrimaryComponentTick.bCanEverTick = true;
+            Perception->RegisterComponent();
+    
+            OutComponents.Add(Perception);
+        }
+        return true;
+    }
+    
+    if (Scenario == TEXT("Trivial"))
+    {
+        for (int32 Index = 0; Index < Count; ++Index)
+        {
+            const FVector Location = GetBenchmarkSpawnLocation(Index, Count, 100.0f);
+            AActor* Actor = World->SpawnActor<AActor>(AActor::StaticClass(), Location, FRotator::ZeroRotator, SpawnParams);
+            if (!Actor)
+            {
+                continue;
+            }
+    
+            UEnhancedTickBenchmarkComponent* Component = NewObject<UEnhancedTickBenchmarkComponent>(Actor);
+            Component->RegisterComponent();
+    
+            OutComponents.Add(Component);
+        }
+        return true;
+    }
+    
+    UE_LOG(LogTemp, Error, TEXT("EnhancedTickBenchmark: Unknown scenario %s (expected CMC, Perception or Trivial)"), *Scenario);
+    return false;
+}
+
+// Run one scenario, population and mode in a fresh world
+static bool RunBenchmark(const FEnhancedTickBenchmarkOptions& Options, FEnhancedTickBenchmarkRun& Run)
+{
+    UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("EnhancedTickBenchmark"));
+    FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+    WorldContext.SetCurrentWorld(World);
+    World->InitializeActorsForPlay(FURL());
+    
+    // Everything is spawned and registered before BeginPlay, so native tick functions of registered components
+    // are never added to the level
+    TArray<UActorComponent*> Components;
+    TArray<ACharacter*> Characters;
+    bool bSpawned = SpawnBenchmarkPopulation(World, Run.Scenario, Run.Count, Components, Characters);
+    
+    UEnhancedTickSystem* TickSystem = World->GetSubsystem<UEnhancedTickSystem>();
+    if (bSpawned && Run.Mode != EEnhancedTickBenchmarkMode::Native)
+    {
+        if (TickSystem)
+        {
+            const ETickBatchFlags Flags = Run.Mode == EEnhancedTickBenchmarkMode::Parallel ? ETickBatchFlags::UseParallel : ETickBatchFlags::None;
+            TickSystem->RegisterComponents(Components, Flags);
+        }
+        else
+        {
+            UE_LOG(LogTemp, Error, TEXT("EnhancedTickBenchmark: No EnhancedTickSystem in the benchmark world"));
+            bSpawned = false;
+        }
+    }
+    
+    if (bSpawned)
+    {
+        // Without a game mode nothing starts play for the actors, so the world settings do it
+        World->BeginPlay();
+        if (!World->HasBegunPlay())
+        {
+            World->GetWorldSettings()->NotifyBeginPlay();
+        }
+    
+        const int32 NumMoving = FMath::RoundToInt(Characters.Num() * FMath::Clamp(Options.MovingFraction, 0.0f, 1.0f));
+        Run.FrameTimesMs.Reserve(Options.Frames);
+    
+        for (int32 Frame = 0; Frame < Options.WarmupFrames + Options.Frames; ++Frame)
+        {
+            // The moving share walks in slowly turning directions, the rest stands still
+            const float Angle = Frame * 0.05f;
+            for (int32 Index = 0; Index < NumMoving; ++Index)
+            {
+                Characters[Index]->AddMovementInput(FVector(FMath::Cos(Angle + Index), FMath::Sin(Angle + Index), 0.0f));
+            }
+    
+            // Measured discarding the warmup, so the registration and the first sort are excluded
+            if (Frame == Options.WarmupFrames && TickSystem)
+            {
+                TickSystem->ResetBatchStats();
+            }
+    
+            const double StartTime = FPlatformTime::Seconds();
+            World->Tick(LEVELTICK_All, Options.DeltaTime);
+            const double EndTime = FPlatformTime::Seconds();
+    
+            GFrameCounter++;
+    
+            if (Frame >= Options.WarmupFrames)
+            {
+                Run.FrameTimesMs.Add(float((EndTime - StartTime) * 1000.0));
+            }
+        }
+    
+        if (TickSystem && Run.Mode != EEnhancedTickBenchmarkMode::Native)
+        {
+            Run.BatchStats = TickSystem->GetBatchStats();
+        }
+    }
+    
+    GEngine->DestroyWorldContext(World);
+    World->DestroyWorld(false);
+    CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+    
+    return bSpawned;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// UEnhancedTickBenchmarkCommandlet Implementation
+
+UEnhancedTickBenchmarkCommandlet::UEnhancedTickBenchmarkCommandlet()
+{
+    IsClient = false;
+    IsServer = true;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 UEnhancedTickBenchmarkCommandlet::Main(const FString& Params)
+{
+    FEnhancedTickBenchmarkOptions Options;
+    FParse::Value(*Params, TEXT("Frames="), Options.Frames);
+    FParse::Value(*Params, TEXT("Warmup="), Options.WarmupFrames);
+    FParse::Value(*Params, TEXT("DeltaTime="), Options.DeltaTime);
+    FParse::Value(*Params, TEXT("MovingFraction="), Options.MovingFraction);
+    Options.Frames = FMath::Max(1, Options.Frames);
+    Options.WarmupFrames = FMath::Max(0, Options.WarmupFrames);
+    
+    FString OutputDir = FPaths::Combine(FPaths::ProfilingDir(), TEXT("EnhancedTick"));
+    FParse::Value(*Params, TEXT("Output="), OutputDir);
+    
+    const TArray<FString> Scenarios = ParseListOption(Params, TEXT("Scenarios="), TEXT("CMC,Perception,Trivial"));
+    const TArray<FString> CountStrings = ParseListOption(Params, TEXT("Counts="), TEXT("1000,10000,50000"));
+    const TArray<FString> ModeStrings = ParseListOption(Params, TEXT("Modes="), TEXT("Native,Serial,Parallel"));
+    
+    TArray<EEnhancedTickBenchmarkMode> Modes;
+    for (const FString& ModeString : ModeStrings)
+    {
+        if (ModeString == TEXT("Native"))
+        {
+            Modes.Add(EEnhancedTickBenchmarkMode::Native);
+        }
+        else if (ModeString == TEXT("Serial"))
+        {
+            Modes.Add(EEnhancedTickBenchmarkMode::Serial);
+        }
+        else if (ModeString == TEXT("Parallel"))
+        {
+            Modes.Add(EEnhancedTickBenchmarkMode::Parallel);
+        }
+        else
+        {
+            UE_LOG(LogTemp, Error, TEXT("EnhancedTickBenchmark: Unknown mode %s (expected Native, Serial or Parallel)"), *ModeString);
+            return 1;
+        }
+    }
+    
+    FString FramesCsv = TEXT("Scenario,Count,Mode,Frame,FrameMs\n");
+    FString SummaryCsv = TEXT("Scenario,Count,Mode,Frames,MeanMs,P50Ms,P95Ms,P99Ms,MaxMs\n");
+    FString BatchCsv = TEXT("Scenario,Count,Mode,Batch,Frames,BatchP50Ms,BatchP95Ms,BatchP99Ms,BatchMaxMs,EntityP50Ns,EntityP95Ns,EntityP99Ns,EntityMaxNs,EntitiesP50,CacheMissesPerEntityP50,IPCP50\n");
+    int32 NumFailed = 0;
+    
+    for (const FString& Scenario : Scenarios)
+    {
+        for (const FString& CountString : CountStrings)
+        {
+            const int32 Count = FCString::Atoi(*CountString);
+            if (Count <= 0)
+            {
+                continue;
+            }
+    
+            for (const EEnhancedTickBenchmarkMode Mode : Modes)
+            {
+                FEnhancedTickBenchmarkRun Run;
+                Run.Scenario = Scenario;
+                Run.Count = Count;
+                Run.Mode = Mode;
+    
+                UE_LOG(LogTemp, Display, TEXT("EnhancedTickBenchmark: %s x%d, %s"), *Scenario, Count, GetBenchmarkModeName(Mode));
+                if (!RunBenchmark(Options, Run))
+                {
+                    ++NumFailed;
+                    continue;
+                }
+    
+                const FString RunKey = FString::Printf(TEXT("%s,%d,%s"), *Scenario, Count, GetBenchmarkModeName(Mode));
+    
+                double TotalMs = 0.0;
+                for (int32 Frame = 0; Frame < Run.FrameTimesMs.Num(); ++Frame)
+                {
+                    FramesCsv += FString::Printf(TEXT("%s,%d,%.4f\n"), *RunKey, Frame, Run.FrameTimesMs[Frame]);
+                    TotalMs += Run.FrameTimesMs[Frame];
+                }
+    
+                TArray<float> Sorted = Run.FrameTimesMs;
+                Sorted.Sort();
+                const float MeanMs = Sorted.Num() > 0 ? float(TotalMs / Sorted.Num()) : 0.0f;
+                SummaryCsv += FString::Printf(TEXT("%s,%d,%.4f,%.4f,%.4f,%.4f,%.4f\n"), *RunKey, Sorted.Num(), MeanMs,
+                    GetSortedPercentile(Sorted, 0.50f), GetSortedPercentile(Sorted, 0.95f), GetSortedPercentile(Sorted, 0.99f),
+                    Sorted.Num() > 0 ? Sorted.Last() : 0.0f);
+    
+                for (const FEnhancedTickBatchStats& Stats : Run.BatchStats)
+                {
+                    BatchCsv += FString::Printf(TEXT("%s,%s,%d,%.4f,%.4f,%.4f,%.4f,%.1f,%.1f,%.1f,%.1f,%.0f,%.3f,%.3f\n"), *RunKey, *GetNameSafe(Stats.BatchClass), Stats.NumFrames,
+                        Stats.BatchTimeMs.P50, Stats.BatchTimeMs.P95, Stats.BatchTimeMs.P99, Stats.BatchTimeMs.Max,
+                        Stats.EntityCostNs.P50, Stats.EntityCostNs.P95, Stats.EntityCostNs.P99, Stats.EntityCostNs.Max,
+                        Stats.EntityCount.P50, Stats.CacheMissesPerEntity.P50, Stats.InstructionsPerCycle.P50);
+                }
+    
+                UE_LOG(LogTemp, Display, TEXT("EnhancedTickBenchmark:   mean %.3f ms, p95 %.3f ms"), MeanMs, GetSortedPercentile(Sorted, 0.95f));
+            }
+        }
+    }
+    
+    const bool bSaved =
+        FFileHelper::SaveStringToFile(FramesCsv, *FPaths::Combine(OutputDir, TEXT("FrameTimes.csv"))) &&
+        FFileHelper::SaveStringToFile(SummaryCsv, *FPaths::Combine(OutputDir, TEXT("Summary.csv"))) &&
+        FFileHelper::SaveStringToFile(BatchCsv, *FPaths::Combine(OutputDir, TEXT("BatchStats.csv")));
+    
+    if (!bSaved)
+    {
+        UE_LOG(LogTemp, Error, TEXT("EnhancedTickBenchmark: Could not write the results to %s"), *OutputDir);
+        return 1;
+    }
+    
+    UE_LOG(LogTemp, Display, TEXT("EnhancedTickBenchmark: Results written to %s"), *OutputDir);
+    return NumFailed > 0 ? 1 : 0;
+}
@@ -0,0 +1,172 @@
+// Copyright (C) Thyke 2025 All Rights Reserved.
+
+#include "EnhancedTickScheduler.h"
+#include "EnhancedTickSystem.h"
+#include "Async/TaskGraphInterfaces.h"
+
+// Default weight of worlds without players (previews, empty server worlds) relative to worlds with players
+#define ENHANCED_TICK_PLAYERLESS_WORLD_WEIGHT 0.25f
+
+UEnhancedTickScheduler::UEnhancedTickScheduler()
+    : TotalWeight(0.0f)
+    , PlayerlessWorldWeight(ENHANCED_TICK_PLAYERLESS_WORLD_WEIGHT)
+    , bShareWorkers(true)
+    , GlobalBudgetCycles(0)
+    , GlobalCyclesUsed(0)
+    , BudgetFrame(0)
+    , InFlightWorkers(0)
+{
+}
+
+void UEnhancedTickScheduler::Deinitialize()
+{
+    // World subsystems are gone before engine subsystems, so nothing is in flight any more
+    Worlds.Empty();
+    TotalWeight = 0.0f;
+    
+    Super::Deinitialize();
+}
+
+void UEnhancedTickScheduler::SetGlobalFrameBudget(float Milliseconds)
+{
+    GlobalBudgetCycles = Milliseconds > 0.0f ? uint64(Milliseconds * 0.001 / FPlatformTime::GetSecondsPerCycle64()) : 0;
+}
+
+void UEnhancedTickScheduler::SetPlayerlessWorldWeight(float Weight)
+{
+    PlayerlessWorldWeight = FMath::Clamp(Weight, 0.0f, 1.0f);
+}
+
+void UEnhancedTickScheduler::SetWorkerSharing(bool bEnabled)
+{
+    bShareWorkers = bEnabled;
+}
+
+void UEnhancedTickScheduler::RegisterSystem(const UEnhancedTickSystem* System)
+{
+    check(IsInGameThread());
+    
+    if (!FindWorld(System))
+    {
+        // New worlds count fully until their first frame tells whether they have players
+        Worlds.Add(FWorldEntry{ System, 1.0f, 0 });
+        TotalWeight += 1.0f;
+    }
+}
+
+void UEnhancedTickScheduler::UnregisterSystem(const UEnhancedTickSystem* System)
+{
+    check(IsInGameThread());
+    
+    const int32 Index = Worlds.IndexOfByPredicate([System](const FWorldEntry& Entry) { return Entry.System == System; });
+    if (Index != INDEX_NONE)
+    {
+        TotalWeight = FMath::Max(0.0f, TotalWeight - Worlds[Index].Weight);
+        Worlds.RemoveAtSwap(Index);
+    }
+}
+
+UEnhancedTickScheduler::FWorldEntry* UEnhancedTickScheduler::FindWorld(const UEnhancedTickSystem* System)
+{
+    return Worlds.FindByPredicate([System](const FWorldEntry& Entry) { return Entry.System == System; });
+}
+
+const UEnhancedTickScheduler::FWorldEntry* UEnhancedTickScheduler::FindWorld(const UEnhancedTickSystem* System) const
+{
+    return Worlds.FindByPredicate([System](const FWorldEntry& Entry) { return Entry.System == System; });
+}
+
+void UEnhancedTickScheduler::BeginWorldFrame(const UEnhancedTickSystem* System, bool bHasPlayers)
+{
+    check(IsInGameThread());
+    
+    // All worlds tick within one engine frame, so the first of them starts the new global frame
+    if (BudgetFrame != GFrameCounter)
+    {
+        BudgetFrame = GFrameCounter;
+        GlobalCyclesUsed = 0;
+        for (FWorldEntry& Entry : Worlds)
+        {
+            Entry.CyclesUsed = 0;
+        }
+    }
+    
+    if (FWorldEntry* Entry = FindWorld(System))
+    {
+        const float Weight = bHasPlayers ? 1.0f : PlayerlessWorldWeight;
+        TotalWeight = FMath::Max(0.0f, TotalWeight + Weight - Entry->Weight);
+        Entry->Weight = Weight;
+    }
+}
+
+int64 UEnhancedTickScheduler::GetRemainingCycles(const UEnhancedTickSystem* System) const
+{
+    if (GlobalBudgetCycles == 0)
+    {
+        return MAX_int64;
+    }
+    
+    int64 Remaining = int64(GlobalBudgetCycles) - int64(GlobalCyclesUsed);
+    
+    // No world may use more than its share, even when it ticks first
+    if (const FWorldEntry* Entry = FindWorld(System))
+    {
+        const int64 Allotment = int64(GlobalBudgetCycles * GetWorldShare(*Entry));
+        Remaining = FMath::Min(Remaining, Allotment - int64(Entry->CyclesUsed));
+    }
+    
+    return Remaining;
+}
+
+void UEnhancedTickScheduler::ChargeCycles(const UEnhancedTickSystem* System, uint64 Cycles)
+{
+    GlobalCyclesUsed += Cycles;
+    
+    if (FWorldEntry* Entry = FindWorld(System))
+    {
+        Entry->CyclesUsed += Cycles;
+    }
+}
+
+int32 UEnhancedTickScheduler::GetWorkerShare(const UEnhancedTickSystem* System) const
+{
+    const int32 NumWorkers = FTaskGraphInterface::Get().GetNumWorkerThreads();
+    
+    const FWorldEntry* Entry = FindWorld(System);
+    if (!bShareWorkers || !Entry)
+    {
+        return NumWorkers;
+    }
+    
+    return FMath::Clamp(FMath::RoundToInt(NumWorkers * GetWorldShare(*Entry)), 1, NumWorkers);
+}
+
+int32 UEnhancedTickScheduler::AcquireWorkers(int32 Desired, int32 Minimum)
+{
+    // Slots are counted even without sharing, so the policy can be switched while ticks are in flight
+    if (!bShareWorkers)
+    {
+        InFlightWorkers.fetch_add(Desired, std::memory_order_relaxed);
+        return Desired;
+    }
+    
+    const int32 NumWorkers = FTaskGraphInterface::Get().GetNumWorkerThreads();
+    
+    int32 InFlight = InFlightWorkers.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        const int32 Granted = FMath::Max(Minimum, FMath::Min(Desired, NumWorkers - InFlight));
+        if (InFlightWorkers.compare_exchange_weak(InFlight, InFlight + Granted, std::memory_order_relaxed))
+        {
+            return Granted;
+        }
+    }
+}
+
+void UEnhancedTickScheduler::ReleaseWorkers(int32 Num)
+{
+    if (Num > 0)
+    {
+        InFlightWorkers.fetch_sub(Num, std::memory_order_relaxed);
+    }
+}
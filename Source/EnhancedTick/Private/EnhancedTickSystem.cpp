@@ -1,1142 +1,4637 @@
 // Copyright (C) Thyke 2025 All Rights Reserved.
 
 #include "EnhancedTickSystem.h"
+#include "EnhancedTickScheduler.h"
 #include "GameFramework/Actor.h"
 #include "Components/ActorComponent.h"
+#include "Components/SceneComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/Character.h"
+#include "AIController.h"
+#include "Navigation/PathFollowingComponent.h"
+#include "GameFramework/PlayerController.h"
 #include "Perception/AIPerceptionComponent.h"
 #include "Engine/Engine.h"
 #include "DrawDebugHelpers.h"
 #include "ProfilingDebugging/CsvProfiler.h"
 #include "EngineUtils.h" // For TActorIterator
+#include "Engine/Level.h"
 #include "HAL/ThreadManager.h"
 #include "HAL/LowLevelMemTracker.h"
+#include "Async/ParallelFor.h"
+#include "Misc/ScopeExit.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Trace/Trace.inl"
+#include <atomic>
+#include <algorithm>
 
-// Helper for prefetching data on platforms that support prefetching
-#if !UE_BUILD_SHIPPING && !UE_BUILD_TEST
-#define ENHANCED_TICK_PREFETCH_DATA(Ptr) FPlatformMisc::Prefetch(Ptr)
-#else
-#define ENHANCED_TICK_PREFETCH_DATA(Ptr)
+#if PLATFORM_LINUX
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 #endif
 
 // L1 and L2 cache line size (usually 64 bytes)
 #define CACHE_LINE_SIZE 64
 
+// Target duration of one parallel chunk, used to derive the grain size from the measured cost per entity
+#define ENHANCED_TICK_PARALLEL_CHUNK_TARGET_NS 20000.0f
+
+// Minimum number of chunks per participating thread, so that skewed costs can be rebalanced
+#define ENHANCED_TICK_MIN_CHUNKS_PER_THREAD 4
+
+// Number of bits per axis in a 3D Morton key (3 x 21 = 63 bits)
+#define ENHANCED_TICK_MORTON_BITS 21
+
+// Initial pool range of a spatial grid cell (doubled when full). A multiple of four, so every cell range
+// can be read as whole groups of four position lanes.
+#define ENHANCED_TICK_GRID_CELL_CAPACITY 4
+static_assert(ENHANCED_TICK_GRID_CELL_CAPACITY % 4 == 0, "Grid cell ranges must hold whole vector registers");
+
+// Occupied cells per parallel chunk of a batched spatial lookup
+#define ENHANCED_TICK_QUERY_CELLS_PER_CHUNK 16
+
+// Entities per parallel chunk of the per-frame position gather
+#define ENHANCED_TICK_POSITION_GATHER_CHUNK 256
+
+// Idle characters skipped by the movement kernel still tick once every this many frames, so state the
+// kernel cannot observe (pending impulses, forced updates) is applied with a bounded delay
+#define ENHANCED_TICK_IDLE_CHARACTER_INTERVAL 16
+
+// Maximum number of coarse occupancy levels of the spatial grid (4 bits of level in a cell key)
+#define ENHANCED_TICK_MAX_GRID_LEVELS 8
+
+// Number of batches listed with their rolling statistics in GetDetailedStats
+#define ENHANCED_TICK_DETAILED_STATS_BATCHES 10
+
+// Ticked frames per measurement window of the adaptive optimizer
+#define ENHANCED_TICK_ADAPTIVE_WINDOW_FRAMES 16
+
+// Incumbent windows between two sampling rounds (a round samples every other candidate for one window)
+#define ENHANCED_TICK_ADAPTIVE_ROUND_INTERVAL 32
+
+// A challenger has to be this much faster than the incumbent, in this many consecutive rounds, to take over
+#define ENHANCED_TICK_ADAPTIVE_MARGIN 0.1
+#define ENHANCED_TICK_ADAPTIVE_CONFIRMATIONS 2
+
+// Batches with fewer active entities keep their mode; parallel dispatch does not pay off below this
+#define ENHANCED_TICK_ADAPTIVE_MIN_ENTITIES 64
+
+// Per-entity cost band of the LowPrio demotion: demoted when the window p95 is below the lower bound,
+// promoted back once the window p50 is above the upper one
+#define ENHANCED_TICK_LOWPRIO_DEMOTE_NS 100.0f
+#define ENHANCED_TICK_LOWPRIO_PROMOTE_NS 200.0f
+
 // Definition of statistic variables - these were declared as extern in the header
 DEFINE_STAT(STAT_EnhancedTick_Total);
 DEFINE_STAT(STAT_EnhancedTick_TypeBatches);
-DEFINE_STAT(STAT_EnhancedTick_SpatialBatches);
+DEFINE_STAT(STAT_EnhancedTick_PositionRefresh);
+DEFINE_STAT(STAT_EnhancedTick_NeighbourCache);
 DEFINE_STAT(STAT_EnhancedTick_CacheMisses);
 
 // Statistic definitions should not be repeated here if they were declared with DECLARE_STAT in the header.
 // STAT definitions must be done only once.
 
-//////////////////////////////////////////////////////////////////////////
-// FComponentTypeBatch Implementation
+UE_TRACE_CHANNEL_DEFINE(EnhancedTickChannel);
 
-void FComponentTypeBatch::TickBatch(float DeltaTime)
+UE_TRACE_EVENT_BEGIN(EnhancedTick, SchedulingDecision)
+    UE_TRACE_EVENT_FIELD(uint64, Cycle)
+    UE_TRACE_EVENT_FIELD(uint8, Decision)
+    UE_TRACE_EVENT_FIELD(int32, Value)
+    UE_TRACE_EVENT_FIELD(int32, Detail)
+    UE_TRACE_EVENT_FIELD(UE::Trace::WideString, BatchName)
+UE_TRACE_EVENT_END()
+
+// Hardware counters are opt-in and process wide; every thread opens its own counter group on first use
+static std::atomic<bool> GEnhancedTickHardwareCountersEnabled(false);
+
+#if PLATFORM_LINUX
+
+// perf_event_open counter group of the calling thread: cycles (group leader), instructions, last level cache misses.
+// The group is read in one call, so the three values always cover the same interval.
+struct FEnhancedTickPerfCounters
 {
-    LastFrameTickCount = 0;
+    int32 Fds[3];
+    bool bOpened;
+    bool bAvailable;
     
-    if (TickEntities.Num() == 0 || !BatchTickFunction)
-    {
-        return;
-    }
+    FEnhancedTickPerfCounters() : Fds{ -1, -1, -1 }, bOpened(false), bAvailable(false) {}
     
-    // Sort for optimized tick processing if cache locality sorting is enabled
-    if (bSortByCacheLocality)
+    ~FEnhancedTickPerfCounters()
     {
-        SortForCacheLocality();
+        Close();
     }
     
-    // For low priority batches when FPS is below a certain threshold,
-    // tick not every frame but once every few frames.
-    if (EnumHasAnyFlags(Flags, ETickBatchFlags::LowPrio) && FApp::GetCurrentTime() < 30.0f)
+    // Open the group once per thread; a failure (unsupported PMU, perf_event_paranoid) is not retried
+    bool Open()
     {
-        // Skip low priority batches under low FPS conditions
-        return;
+        if (bOpened)
+        {
+            return bAvailable;
+        }
+        bOpened = true;
+        
+        static const uint64 Configs[3] = { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES };
+        for (int32 Index = 0; Index < 3; ++Index)
+        {
+            struct perf_event_attr Attr;
+            FMemory::Memzero(Attr);
+            Attr.type = PERF_TYPE_HARDWARE;
+            Attr.size = sizeof(Attr);
+            Attr.config = Configs[Index];
+            Attr.read_format = PERF_FORMAT_GROUP;
+            
+            // User space only, which is allowed up to perf_event_paranoid 2 without extra capabilities
+            Attr.exclude_kernel = 1;
+            Attr.exclude_hv = 1;
+            
+            // This thread on any CPU
+            Fds[Index] = int32(syscall(__NR_perf_event_open, &Attr, 0, -1, Index == 0 ? -1 : Fds[0], 0));
+            if (Fds[Index] < 0)
+            {
+                Close();
+                return false;
+            }
+        }
+        
+        bAvailable = true;
+        return true;
     }
     
-    // Filter active entities
-    TArray<FTickEntityData> ActiveEntities;
-    ActiveEntities.Reserve(TickEntities.Num());
-    
-    for (auto& Entity : TickEntities)
+    void Close()
     {
-        if (Entity.bEnabled && IsValid(Entity.Object))
+        for (int32& Fd : Fds)
         {
-            ActiveEntities.Add(Entity);
+            if (Fd >= 0)
+            {
+                close(Fd);
+                Fd = -1;
+            }
         }
     }
     
-    if (ActiveEntities.Num() == 0)
+    bool Read(FEnhancedTickHardwareCounters& Out) const
     {
-        return;
+        // Number of counters, then the values in group order
+        uint64 Values[4];
+        if (read(Fds[0], Values, sizeof(Values)) != ssize_t(sizeof(Values)) || Values[0] != 3)
+        {
+            return false;
+        }
+        
+        Out.Cycles = Values[1];
+        Out.Instructions = Values[2];
+        Out.CacheMisses = Values[3];
+        return true;
     }
-    
-    // Call the BatchTickFunction for all active objects
-    const double StartTime = FPlatformTime::Seconds();
-    
-    // Optimize cache usage using prefetch (load the first entity)
-    if (ActiveEntities.Num() > 0)
+};
+
+static thread_local FEnhancedTickPerfCounters GEnhancedTickThreadCounters;
+
+#endif // PLATFORM_LINUX
+
+// Current counter values of the calling thread, false if the counters are off or unavailable on this thread
+static bool ReadThreadHardwareCounters(FEnhancedTickHardwareCounters& Out)
+{
+#if PLATFORM_LINUX
+    if (GEnhancedTickHardwareCountersEnabled.load(std::memory_order_relaxed) && GEnhancedTickThreadCounters.Open())
     {
-        ENHANCED_TICK_PREFETCH_DATA(ActiveEntities[0].Object);
+        return GEnhancedTickThreadCounters.Read(Out);
     }
+#endif
+    return false;
+}
+
+// Counts the hardware events of the calling thread between construction and Stop()
+struct FEnhancedTickHardwareCounterScope
+{
+    FEnhancedTickHardwareCounters Start;
+    bool bActive;
     
-    // Lock check - now using a shared pointer for the lock
-    if (BatchLock.IsValid())
-    {
-        FScopeLock Lock(BatchLock.Get());
-        BatchTickFunction(ActiveEntities, DeltaTime);
-    }
-    else
+    FEnhancedTickHardwareCounterScope() : bActive(ReadThreadHardwareCounters(Start)) {}
+    
+    FEnhancedTickHardwareCounters Stop() const
     {
-        BatchTickFunction(ActiveEntities, DeltaTime);
+        FEnhancedTickHardwareCounters Delta;
+        FEnhancedTickHardwareCounters End;
+        if (bActive && ReadThreadHardwareCounters(End))
+        {
+            Delta.Cycles = End.Cycles - Start.Cycles;
+            Delta.Instructions = End.Instructions - Start.Instructions;
+            Delta.CacheMisses = End.CacheMisses - Start.CacheMisses;
+        }
+        return Delta;
     }
-    
-    // Update statistics
-    const double EndTime = FPlatformTime::Seconds();
-    AverageTickTimeNs = float((EndTime - StartTime) * 1.0e9) / ActiveEntities.Num();
-    LastFrameTickCount = ActiveEntities.Num();
+};
+
+// Emit a scheduling decision of a batch on the trace channel (no cost while the channel is off)
+static void TraceSchedulingDecision(EEnhancedTickTraceDecision Decision, const FString& BatchName, int32 Value, int32 Detail)
+{
+    UE_TRACE_LOG(EnhancedTick, SchedulingDecision, EnhancedTickChannel)
+        << SchedulingDecision.Cycle(FPlatformTime::Cycles64())
+        << SchedulingDecision.Decision(uint8(Decision))
+        << SchedulingDecision.Value(Value)
+        << SchedulingDecision.Detail(Detail)
+        << SchedulingDecision.BatchName(*BatchName, BatchName.Len());
 }
 
+// Spread the lower 21 bits of a value so that there are two zero bits between each of them
+static uint64 SpreadMortonBits(uint64 Value)
+{
+    Value &= 0x1FFFFF;
+    Value = (Value | (Value << 32)) & 0x1F00000000FFFFull;
+    Value = (Value | (Value << 16)) & 0x1F0000FF0000FFull;
+    Value = (Value | (Value << 8)) & 0x100F00F00F00F00Full;
+    Value = (Value | (Value << 4)) & 0x10C30C30C30C30C3ull;
+    Value = (Value | (Value << 2)) & 0x1249249249249249ull;
+    return Value;
+}
 
-void FComponentTypeBatch::TickBatchParallel(float DeltaTime)
+// LSD radix sort of (key, index) pairs, 8 bits per pass.
+// Passes where every key shares the same digit are skipped, so keys that only differ in their
+// low bits (a compact level) cost only a few passes.
+static void RadixSortByKey(TArray<uint64>& Keys, TArray<int32>& Values, TArray<uint64>& TempKeys, TArray<int32>& TempValues)
 {
-    LastFrameTickCount = 0;
-    
-    if (TickEntities.Num() == 0 || !BatchTickFunction || !CanTickInParallel())
+    // Nothing to order, and the digit check below reads the first key
+    const int32 Num = Keys.Num();
+    if (Num < 2)
     {
-        TickBatch(DeltaTime);
         return;
     }
     
-    // Sort entities if necessary
-    if (bSortByCacheLocality)
-    {
-        SortForCacheLocality();
-    }
+    TempKeys.SetNumUninitialized(Num, false);
+    TempValues.SetNumUninitialized(Num, false);
     
-    // Filter active entities (preparing for parallel processing)
-    TArray<FTickEntityData> ActiveEntities;
-    ActiveEntities.Reserve(TickEntities.Num());
+    uint64* SrcKeys = Keys.GetData();
+    int32* SrcValues = Values.GetData();
+    uint64* DstKeys = TempKeys.GetData();
+    int32* DstValues = TempValues.GetData();
     
-    // Lock check - using shared pointer for the lock
-    if (BatchLock.IsValid())
+    for (int32 Shift = 0; Shift < 64; Shift += 8)
     {
-        FScopeLock Lock(BatchLock.Get());
-        for (auto& Entity : TickEntities)
+        int32 Counts[256] = { 0 };
+        for (int32 i = 0; i < Num; ++i)
         {
-            if (Entity.bEnabled && IsValid(Entity.Object))
-            {
-                ActiveEntities.Add(Entity);
-            }
+            Counts[(SrcKeys[i] >> Shift) & 0xFF]++;
+        }
+        
+        // All keys share this digit, nothing to do for this pass
+        if (Counts[(SrcKeys[0] >> Shift) & 0xFF] == Num)
+        {
+            continue;
+        }
+        
+        int32 Offset = 0;
+        for (int32 Digit = 0; Digit < 256; ++Digit)
+        {
+            const int32 Count = Counts[Digit];
+            Counts[Digit] = Offset;
+            Offset += Count;
+        }
+        
+        for (int32 i = 0; i < Num; ++i)
+        {
+            const int32 Target = Counts[(SrcKeys[i] >> Shift) & 0xFF]++;
+            DstKeys[Target] = SrcKeys[i];
+            DstValues[Target] = SrcValues[i];
         }
+        
+        Swap(SrcKeys, DstKeys);
+        Swap(SrcValues, DstValues);
+    }
+    
+    // Make sure the result ends up in the input arrays
+    if (SrcKeys != Keys.GetData())
+    {
+        FMemory::Memcpy(Keys.GetData(), SrcKeys, Num * sizeof(uint64));
+        FMemory::Memcpy(Values.GetData(), SrcValues, Num * sizeof(int32));
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FTickEntityStore Implementation
+
+FEnhancedTickHandle FTickEntityStore::Add(UObject* Object, const FVector& Position, uint8 Priority, bool bEnabled)
+{
+    // Reuse a free slot if possible, otherwise grow the slot table
+    uint32 SlotIndex;
+    if (FreeSlots.Num() > 0)
+    {
+        SlotIndex = FreeSlots.Pop(false);
     }
     else
     {
-        for (auto& Entity : TickEntities)
-        {
-            if (Entity.bEnabled && IsValid(Entity.Object))
-            {
-                ActiveEntities.Add(Entity);
-            }
-        }
+        SlotIndex = (uint32)Slots.Add(FSlot{ INDEX_NONE, 0 });
     }
     
-    if (ActiveEntities.Num() == 0)
+    const int32 DenseIndex = Objects.Add(Object);
+    Positions.Add(Position);
+    Priorities.Add(Priority);
+    EnabledFlags.Add(bEnabled);
+    SpatialBucketIds.Add(0);
+    SortKeys.Add(0);
+    LastTickTimes.Add(-1.0);
+    EntityDeltaTimes.Add(0.0f);
+    LODIntervals.Add(0);
+    RelevancyDistancesSq.Add(MAX_flt);
+    DenseToSlot.Add(SlotIndex);
+    DenseToActive.Add(bEnabled ? ActiveIndices.Add(DenseIndex) : INDEX_NONE);
+    bOrderDirty = true;
+    
+    FSlot& Slot = Slots[SlotIndex];
+    Slot.DenseIndex = DenseIndex;
+    
+    return FEnhancedTickHandle(SlotIndex, Slot.Generation);
+}
+
+bool FTickEntityStore::Remove(FEnhancedTickHandle Handle)
+{
+    const int32 DenseIndex = FindDenseIndex(Handle);
+    if (DenseIndex == INDEX_NONE)
     {
-        return;
+        return false;
     }
     
-    // IMPORTANT CHECK FOR THREAD SAFETY:
-    // Check for components (UPrimitiveComponent, USceneComponent, UCharacterMovementComponent)
-    // that may include transform updates and are not thread-safe.
-    bool bMightContainUnsafeComponents = false;
+    RemoveAtSwap(DenseIndex);
+    return true;
+}
+
+void FTickEntityStore::RemoveAtSwap(int32 DenseIndex)
+{
+    check(IsValidIndex(DenseIndex));
+    
+    // Drop the entity from the active list first
+    SetEnabled(DenseIndex, false);
+    
+    // Retire the slot; bumping the generation invalidates every outstanding handle to it
+    const uint32 RemovedSlot = DenseToSlot[DenseIndex];
+    Slots[RemovedSlot].DenseIndex = INDEX_NONE;
+    Slots[RemovedSlot].Generation++;
+    FreeSlots.Add(RemovedSlot);
+    CustomTickFunctions.Remove(RemovedSlot);
     
-    for (const auto& Entity : ActiveEntities)
+    // Move the last entity into the hole
+    const int32 LastIndex = Num() - 1;
+    if (DenseIndex != LastIndex)
     {
-        UObject* Object = Entity.Object;
-        if (Object && (Object->IsA<UPrimitiveComponent>() || 
-                       Object->IsA<USceneComponent>() || 
-                       Object->IsA<UCharacterMovementComponent>()))
+        Objects[DenseIndex] = Objects[LastIndex];
+        Positions[DenseIndex] = Positions[LastIndex];
+        Priorities[DenseIndex] = Priorities[LastIndex];
+        EnabledFlags[DenseIndex] = (bool)EnabledFlags[LastIndex];
+        SpatialBucketIds[DenseIndex] = SpatialBucketIds[LastIndex];
+        SortKeys[DenseIndex] = SortKeys[LastIndex];
+        LastTickTimes[DenseIndex] = LastTickTimes[LastIndex];
+        EntityDeltaTimes[DenseIndex] = EntityDeltaTimes[LastIndex];
+        LODIntervals[DenseIndex] = LODIntervals[LastIndex];
+        RelevancyDistancesSq[DenseIndex] = RelevancyDistancesSq[LastIndex];
+        DenseToSlot[DenseIndex] = DenseToSlot[LastIndex];
+        DenseToActive[DenseIndex] = DenseToActive[LastIndex];
+        
+        Slots[DenseToSlot[DenseIndex]].DenseIndex = DenseIndex;
+        if (DenseToActive[DenseIndex] != INDEX_NONE)
         {
-            bMightContainUnsafeComponents = true;
-            break;
+            ActiveIndices[DenseToActive[DenseIndex]] = DenseIndex;
         }
+        bOrderDirty = true;
     }
     
-    // Use the standard tick for thread-unsafe components
-    if (bMightContainUnsafeComponents)
+    Objects.RemoveAt(LastIndex, 1, false);
+    Positions.RemoveAt(LastIndex, 1, false);
+    Priorities.RemoveAt(LastIndex, 1, false);
+    EnabledFlags.RemoveAt(LastIndex);
+    SpatialBucketIds.RemoveAt(LastIndex, 1, false);
+    SortKeys.RemoveAt(LastIndex, 1, false);
+    LastTickTimes.RemoveAt(LastIndex, 1, false);
+    EntityDeltaTimes.RemoveAt(LastIndex, 1, false);
+    LODIntervals.RemoveAt(LastIndex, 1, false);
+    RelevancyDistancesSq.RemoveAt(LastIndex, 1, false);
+    DenseToSlot.RemoveAt(LastIndex, 1, false);
+    DenseToActive.RemoveAt(LastIndex, 1, false);
+}
+
+void FTickEntityStore::SetCustomTickFunction(FEnhancedTickHandle Handle, TFunction<void(float)>&& TickFunction)
+{
+    if (FindDenseIndex(Handle) != INDEX_NONE)
+    {
+        CustomTickFunctions.Add(Handle.Index, MoveTemp(TickFunction));
+    }
+}
+
+void FTickEntityStore::SetEnabled(int32 DenseIndex, bool bEnabled)
+{
+    if (EnabledFlags[DenseIndex] == bEnabled)
     {
-        TickBatch(DeltaTime);
         return;
     }
     
-    const double StartTime = FPlatformTime::Seconds();
-    LastFrameTickCount = ActiveEntities.Num();
-    
-    // Determine the number of worker threads available
-    const int32 NumThreads = FPlatformMisc::NumberOfWorkerThreadsToSpawn();
-    const int32 EntitiesPerThread = FMath::Max(1, FMath::CeilToInt(float(ActiveEntities.Num()) / NumThreads));
-    
-    // Use TaskGraph for parallel processing
-    FGraphEventArray Tasks;
-    Tasks.Reserve(NumThreads);
+    EnabledFlags[DenseIndex] = bEnabled;
     
-    for (int32 ThreadIdx = 0; ThreadIdx < NumThreads; ++ThreadIdx)
+    if (bEnabled)
     {
-        const int32 StartIdx = ThreadIdx * EntitiesPerThread;
-        const int32 EndIdx = FMath::Min(StartIdx + EntitiesPerThread, ActiveEntities.Num());
-        
-        if (StartIdx >= EndIdx)
-        {
-            continue;
-        }
+        DenseToActive[DenseIndex] = ActiveIndices.Add(DenseIndex);
         
-        // Create a task for each thread
-        Tasks.Add(FFunctionGraphTask::CreateAndDispatchWhenReady([this, &ActiveEntities, StartIdx, EndIdx, DeltaTime]()
-        {
-            // Tick the entities assigned to this thread
-            TArrayView<FTickEntityData> ThreadView(&ActiveEntities[StartIdx], EndIdx - StartIdx);
-            
-            // Optimize sub-tasks with prefetch
-            for (int32 i = 0; i < ThreadView.Num(); ++i)
-            {
-                // Prefetch the next entity to increase cache hit rate
-                if (i + 1 < ThreadView.Num())
-                {
-                    ENHANCED_TICK_PREFETCH_DATA(ThreadView[i + 1].Object);
-                }
-                
-                // Tick a single object
-                if (ThreadView[i].TickFunction)
-                {
-                    ThreadView[i].TickFunction(DeltaTime);
-                }
-            }
-        }, TStatId(), nullptr, ENamedThreads::AnyThread));
+        // Time spent disabled is not handed to the next tick
+        LastTickTimes[DenseIndex] = -1.0;
+    }
+    else
+    {
+        // Swap-remove from the packed list and patch the entity that moved
+        const int32 ActivePos = DenseToActive[DenseIndex];
+        const int32 LastActive = ActiveIndices.Last();
+        ActiveIndices[ActivePos] = LastActive;
+        DenseToActive[LastActive] = ActivePos;
+        ActiveIndices.Pop(false);
+        DenseToActive[DenseIndex] = INDEX_NONE;
+    }
+}
+
+void FTickEntityStore::RebuildActiveIndices()
+{
+    ActiveIndices.Reset();
+    for (TConstSetBitIterator<> It(EnabledFlags); It; ++It)
+    {
+        DenseToActive[It.GetIndex()] = ActiveIndices.Add(It.GetIndex());
+    }
+}
+
+int32 FTickEntityStore::FindDenseIndex(FEnhancedTickHandle Handle) const
+{
+    if (!Handle.IsValid() || !Slots.IsValidIndex(Handle.Index))
+    {
+        return INDEX_NONE;
     }
     
-    // Wait for all tasks to complete
-    FTaskGraphInterface::Get().WaitUntilTasksComplete(Tasks);
+    const FSlot& Slot = Slots[Handle.Index];
+    return Slot.Generation == Handle.Generation ? Slot.DenseIndex : INDEX_NONE;
+}
+
+int32 FTickEntityStore::FindDenseIndex(const UObject* Object) const
+{
+    // Only the object column is touched while searching
+    return Objects.IndexOfByKey(Object);
+}
+
+FEnhancedTickHandle FTickEntityStore::GetHandle(int32 DenseIndex) const
+{
+    if (!IsValidIndex(DenseIndex))
+    {
+        return FEnhancedTickHandle();
+    }
     
-    // Update statistics
-    const double EndTime = FPlatformTime::Seconds();
-    AverageTickTimeNs = float((EndTime - StartTime) * 1.0e9) / ActiveEntities.Num();
+    const uint32 SlotIndex = DenseToSlot[DenseIndex];
+    return FEnhancedTickHandle(SlotIndex, Slots[SlotIndex].Generation);
 }
 
-void FComponentTypeBatch::SortForCacheLocality()
+void FTickEntityStore::SwapEntities(int32 DenseIndexA, int32 DenseIndexB)
 {
-    if (TickEntities.Num() < 2)
+    if (DenseIndexA == DenseIndexB)
     {
         return;
     }
     
-    // Sorting strategy for cache locality
-    // More advanced spatial sorting such as Hilbert curves could be used here
+    Objects.Swap(DenseIndexA, DenseIndexB);
+    Positions.Swap(DenseIndexA, DenseIndexB);
+    Priorities.Swap(DenseIndexA, DenseIndexB);
+    SpatialBucketIds.Swap(DenseIndexA, DenseIndexB);
+    SortKeys.Swap(DenseIndexA, DenseIndexB);
+    LastTickTimes.Swap(DenseIndexA, DenseIndexB);
+    EntityDeltaTimes.Swap(DenseIndexA, DenseIndexB);
+    LODIntervals.Swap(DenseIndexA, DenseIndexB);
+    RelevancyDistancesSq.Swap(DenseIndexA, DenseIndexB);
+    DenseToSlot.Swap(DenseIndexA, DenseIndexB);
+    DenseToActive.Swap(DenseIndexA, DenseIndexB);
     
-    // Simple distance-based greedy sorting
-    TArray<FTickEntityData> SortedEntities;
-    SortedEntities.Reserve(TickEntities.Num());
+    const bool bEnabledA = EnabledFlags[DenseIndexA];
+    EnabledFlags[DenseIndexA] = (bool)EnabledFlags[DenseIndexB];
+    EnabledFlags[DenseIndexB] = bEnabledA;
     
-    // Filter out inactive or invalid objects
-    TArray<FTickEntityData> ValidEntities;
-    for (auto& Entity : TickEntities)
+    Slots[DenseToSlot[DenseIndexA]].DenseIndex = DenseIndexA;
+    Slots[DenseToSlot[DenseIndexB]].DenseIndex = DenseIndexB;
+    
+    if (DenseToActive[DenseIndexA] != INDEX_NONE)
     {
-        if (Entity.bEnabled && IsValid(Entity.Object))
-        {
-            ValidEntities.Add(Entity);
-        }
+        ActiveIndices[DenseToActive[DenseIndexA]] = DenseIndexA;
     }
-    
-    if (ValidEntities.Num() < 2)
+    if (DenseToActive[DenseIndexB] != INDEX_NONE)
     {
-        return;
+        ActiveIndices[DenseToActive[DenseIndexB]] = DenseIndexB;
     }
+}
+
+void FTickEntityStore::ApplyPermutation(TArrayView<const int32> NewOrder, TArray<int32>& Location, TArray<int32>& Occupant)
+{
+    check(NewOrder.Num() == Num());
     
-    // Start by adding the first object
-    SortedEntities.Add(ValidEntities[0]);
-    ValidEntities.RemoveAt(0);
+    // Follow the cycles of the permutation with swaps, so no column is ever copied.
+    // Location tracks where each original entity currently sits, Occupant the inverse.
+    Location.SetNumUninitialized(Num(), false);
+    Occupant.SetNumUninitialized(Num(), false);
+    for (int32 i = 0; i < Num(); ++i)
+    {
+        Location[i] = i;
+        Occupant[i] = i;
+    }
     
-    // Iteratively find the nearest next object
-    while (ValidEntities.Num() > 0)
+    for (int32 NewIndex = 0; NewIndex < NewOrder.Num(); ++NewIndex)
     {
-        const FTickEntityData& LastAdded = SortedEntities.Last();
-        int32 BestIdx = 0;
-        float BestDistance = LastAdded.GetDistance(ValidEntities[0]);
-        
-        // Find the closest neighbor
-        for (int32 i = 1; i < ValidEntities.Num(); ++i)
+        const int32 Wanted = NewOrder[NewIndex];
+        const int32 Current = Location[Wanted];
+        if (Current != NewIndex)
         {
-            const float Dist = LastAdded.GetDistance(ValidEntities[i]);
-            if (Dist < BestDistance)
-            {
-                BestDistance = Dist;
-                BestIdx = i;
-            }
+            const int32 Displaced = Occupant[NewIndex];
+            SwapEntities(NewIndex, Current);
+            
+            Occupant[Current] = Displaced;
+            Location[Displaced] = Current;
+            Occupant[NewIndex] = Wanted;
+            Location[Wanted] = NewIndex;
         }
-        
-        // Add the closest neighbor
-        SortedEntities.Add(ValidEntities[BestIdx]);
-        ValidEntities.RemoveAt(BestIdx);
     }
     
-    // Copy the sorted array back to the TickEntities array
-    TickEntities = SortedEntities;
+    // Keep the active list streaming in the new dense order
+    RebuildActiveIndices();
 }
 
-//////////////////////////////////////////////////////////////////////////
-// FSpatialEntityBatch Implementation
+void FTickEntityStore::Reserve(int32 Number)
+{
+    Objects.Reserve(Number);
+    Positions.Reserve(Number);
+    Priorities.Reserve(Number);
+    EnabledFlags.Reserve(Number);
+    SpatialBucketIds.Reserve(Number);
+    SortKeys.Reserve(Number);
+    LastTickTimes.Reserve(Number);
+    EntityDeltaTimes.Reserve(Number);
+    LODIntervals.Reserve(Number);
+    RelevancyDistancesSq.Reserve(Number);
+    DenseToSlot.Reserve(Number);
+    DenseToActive.Reserve(Number);
+    ActiveIndices.Reserve(Number);
+    Slots.Reserve(Number);
+}
 
-uint16 FSpatialEntityBatch::CalculateGridCell(const FVector& Position) const
+void FTickEntityStore::Empty()
 {
-    // Convert 3D position to 2D grid ID
-    // Simple hash function (more advanced spatial hash functions can be used)
-    const int32 CellX = FMath::FloorToInt(Position.X / GridCellSize);
-    const int32 CellY = FMath::FloorToInt(Position.Y / GridCellSize);
-    const int32 CellZ = FMath::FloorToInt(Position.Z / GridCellSize);
-    
-    // Convert 3D position into a single 16-bit hash
-    // This is just an example - a better hash might be required in a real implementation
-    const uint16 CombinedHash = (uint16)(
-        ((CellX & 0x3F) << 10) |  // 6 bits for X
-        ((CellY & 0x3F) << 4) |   // 6 bits for Y
-        (CellZ & 0xF)             // 4 bits for Z
-    );
-    
-    return CombinedHash;
+    Objects.Empty();
+    Positions.Empty();
+    Priorities.Empty();
+    EnabledFlags.Empty();
+    SpatialBucketIds.Empty();
+    SortKeys.Empty();
+    LastTickTimes.Empty();
+    EntityDeltaTimes.Empty();
+    LODIntervals.Empty();
+    RelevancyDistancesSq.Empty();
+    CustomTickFunctions.Empty();
+    DenseToSlot.Empty();
+    DenseToActive.Empty();
+    ActiveIndices.Empty();
+    Slots.Empty();
+    FreeSlots.Empty();
+    bOrderDirty = false;
+}
+
+SIZE_T FTickEntityStore::GetAllocatedSize() const
+{
+    return Objects.GetAllocatedSize() + Positions.GetAllocatedSize() + Priorities.GetAllocatedSize() + EnabledFlags.GetAllocatedSize()
+        + SpatialBucketIds.GetAllocatedSize() + SortKeys.GetAllocatedSize() + LastTickTimes.GetAllocatedSize()
+        + EntityDeltaTimes.GetAllocatedSize() + LODIntervals.GetAllocatedSize() + RelevancyDistancesSq.GetAllocatedSize() + DenseToSlot.GetAllocatedSize()
+        + ActiveIndices.GetAllocatedSize() + DenseToActive.GetAllocatedSize() + Slots.GetAllocatedSize() + FreeSlots.GetAllocatedSize()
+        + CustomTickFunctions.GetAllocatedSize();
 }
 
-void FSpatialEntityBatch::AddEntity(FTickEntityData* Entity)
+// Tick a range of entities with the entity at SampleOffset ticked and timed on its own.
+// The sample includes the per-call overhead of the kernel, which is small next to the entities worth finding.
+template<typename TTickRange>
+static void TickRangeWithSample(TArrayView<const int32> Indices, int32 SampleOffset, FEnhancedTickEntitySample& OutSample, TTickRange&& TickRange)
 {
-    if (!Entity || !Entity->Object)
+    const int32 Count = Indices.Num();
+    
+    if (SampleOffset > 0)
     {
-        return;
+        TickRange(Indices.Slice(0, SampleOffset));
     }
     
-    // Lock check for thread safety using shared pointer
-    if (SpatialLock.Get())
+    const uint64 StartCycles = FPlatformTime::Cycles64();
+    TickRange(Indices.Slice(SampleOffset, 1));
+    OutSample.Cycles = FPlatformTime::Cycles64() - StartCycles;
+    OutSample.DenseIndex = Indices[SampleOffset];
+    
+    if (SampleOffset + 1 < Count)
     {
-        FScopeLock Lock(SpatialLock.Get());
-        
-        // Calculate grid cell
-        const uint16 GridCell = CalculateGridCell(Entity->Position);
-        Entity->SpatialBucketId = GridCell;
-        
-        // Add to grid cell
-        GridCells.FindOrAdd(GridCell).Add(Entity);
-        AllSpatialEntities.Add(Entity);
+        TickRange(Indices.Slice(SampleOffset + 1, Count - SampleOffset - 1));
     }
-    else
+}
+
+// Keep the Count entries that ticked longest ago, in their original (cache) order. Whatever the budget
+// passes over stays the oldest, so it goes first the next time it is due, however the due set changes.
+template<typename TLastTickTime>
+static void KeepOldestTicks(TArray<int32>& Entries, int32 Count, TLastTickTime&& LastTickTime)
+{
+    std::nth_element(Entries.GetData(), Entries.GetData() + Count, Entries.GetData() + Entries.Num(), [&LastTickTime](int32 A, int32 B)
     {
-        // Calculate grid cell
-        const uint16 GridCell = CalculateGridCell(Entity->Position);
-        Entity->SpatialBucketId = GridCell;
-        
-        // Add to grid cell
-        GridCells.FindOrAdd(GridCell).Add(Entity);
-        AllSpatialEntities.Add(Entity);
-    }
+        return LastTickTime(A) < LastTickTime(B);
+    });
+    
+    Entries.SetNum(Count, false);
+    Entries.Sort();
 }
 
-void FSpatialEntityBatch::RemoveEntity(FTickEntityData* Entity)
+// Nearest-rank percentiles of a window of values
+template<typename TValue>
+static FEnhancedTickPercentiles CalculateWindowPercentiles(const TValue* Values, int32 NumValues)
 {
-    if (!Entity || !Entity->Object)
+    FEnhancedTickPercentiles Percentiles;
+    if (NumValues == 0)
     {
-        return;
+        return Percentiles;
     }
     
-    // Lock check for thread safety
-    if (SpatialLock.Get())
+    TArray<float, TInlineAllocator<FEnhancedTickBatchHistory::NumFrames>> Sorted;
+    Sorted.SetNumUninitialized(NumValues);
+    for (int32 Index = 0; Index < NumValues; ++Index)
     {
-        FScopeLock Lock(SpatialLock.Get());
-        
-        // Remove from grid cell
-        const uint16 GridCell = Entity->SpatialBucketId;
-        if (TArray<FTickEntityData*>* Cell = GridCells.Find(GridCell))
-        {
-            Cell->Remove(Entity);
-            if (Cell->Num() == 0)
-            {
-                GridCells.Remove(GridCell);
-            }
-        }
-        
-        AllSpatialEntities.Remove(Entity);
+        Sorted[Index] = float(Values[Index]);
     }
-    else
+    Sorted.Sort();
+    
+    auto Rank = [&Sorted, NumValues](float Fraction)
     {
-        // Remove from grid cell
-        const uint16 GridCell = Entity->SpatialBucketId;
-        if (TArray<FTickEntityData*>* Cell = GridCells.Find(GridCell))
-        {
-            Cell->Remove(Entity);
-            if (Cell->Num() == 0)
-            {
-                GridCells.Remove(GridCell);
-            }
-        }
-        
-        AllSpatialEntities.Remove(Entity);
-    }
+        return Sorted[FMath::Clamp(FMath::CeilToInt(Fraction * NumValues) - 1, 0, NumValues - 1)];
+    };
+    
+    Percentiles.P50 = Rank(0.50f);
+    Percentiles.P95 = Rank(0.95f);
+    Percentiles.P99 = Rank(0.99f);
+    Percentiles.Max = Sorted.Last();
+    return Percentiles;
 }
 
-void FSpatialEntityBatch::TickAllGrids(float DeltaTime)
+//////////////////////////////////////////////////////////////////////////
+// FEnhancedTickBatchHistory Implementation
+
+void FEnhancedTickBatchHistory::AddFrame(float BatchTimeMs, float EntityCostNs, int32 EntityCount, const FEnhancedTickHardwareCounters& Counters)
 {
-    SCOPE_CYCLE_COUNTER(STAT_EnhancedTick_SpatialBatches);
+    BatchTimesMs[Head] = BatchTimeMs;
+    EntityCostsNs[Head] = EntityCostNs;
+    EntityCounts[Head] = EntityCount;
+    CacheMissesPerEntity[Head] = EntityCount > 0 ? float(double(Counters.CacheMisses) / EntityCount) : 0.0f;
+    InstructionsPerCycle[Head] = Counters.Cycles > 0 ? float(double(Counters.Instructions) / double(Counters.Cycles)) : 0.0f;
     
-    // First, acquire the lock - check the SpatialLock shared pointer
-    FScopeLock ScopeLock(SpatialLock.Get());
+    Head = (Head + 1) % NumFrames;
+    NumSamples = FMath::Min(NumSamples + 1, NumFrames);
+}
+
+void FEnhancedTickBatchHistory::AddOutlier(UObject* Object, float CostNs, uint64 Frame)
+{
+    int32 Target = INDEX_NONE;
+    float TargetCost = CostNs;
     
-    // Tick each grid cell individually
-    for (auto& GridPair : GridCells)
+    for (int32 Index = 0; Index < NumOutliers; ++Index)
     {
-        uint16 GridId = GridPair.Key;
-        TArray<FTickEntityData*>& Entities = GridPair.Value;
+        FOutlier& Outlier = Outliers[Index];
         
-        // If there are too few entities in the grid, skip ticking
-        if (Entities.Num() < 1)
+        // An entity is listed once, with its slowest tick in the window
+        if (Outlier.Object.Get() == Object)
         {
-            continue;
+            if (CostNs >= Outlier.CostNs || Frame - Outlier.Frame >= NumFrames)
+            {
+                Outlier.CostNs = CostNs;
+                Outlier.Frame = Frame;
+            }
+            return;
         }
         
-        // Prefetch the first entity to optimize cache usage
-        if (Entities.Num() > 0 && Entities[0] && Entities[0]->Object)
+        // Free, destroyed and expired entries are taken first, otherwise the cheapest one
+        if (!Outlier.Object.IsValid() || Frame - Outlier.Frame >= NumFrames)
         {
-            ENHANCED_TICK_PREFETCH_DATA(Entities[0]->Object);
+            Target = Index;
+            TargetCost = -1.0f;
         }
-        
-        // Tick each entity - add NULL checks
-        for (int32 i = 0; i < Entities.Num(); ++i)
+        else if (Outlier.CostNs < TargetCost)
         {
-            FTickEntityData* Entity = Entities[i];
-            
-            // NULL check
-            if (!Entity || !IsValid(Entity->Object))
-            {
-                continue;
-            }
-            
-            // Prefetch the next entity
-            if (i + 1 < Entities.Num() && Entities[i + 1] && Entities[i + 1]->Object)
-            {
-                ENHANCED_TICK_PREFETCH_DATA(Entities[i + 1]->Object);
-            }
-            
-            // Tick the entity
-            if (Entity->bEnabled && Entity->TickFunction)
-            {
-                Entity->TickFunction(DeltaTime);
-            }
+            Target = Index;
+            TargetCost = Outlier.CostNs;
         }
     }
+    
+    if (Target != INDEX_NONE)
+    {
+        Outliers[Target].Object = Object;
+        Outliers[Target].CostNs = CostNs;
+        Outliers[Target].Frame = Frame;
+    }
 }
 
-TArray<FTickEntityData*> FSpatialEntityBatch::GetNearbyEntities(const FVector& Position, float Radius)
+void FEnhancedTickBatchHistory::Reset()
 {
-    TArray<FTickEntityData*> NearbyEntities;
-    
-    // Calculate the center grid cell and the surrounding cells
-    const uint16 CenterGridId = CalculateGridCell(Position);
-    
-    // Grid radius (number of cells to check)
-    const int32 GridRadius = FMath::CeilToInt(Radius / GridCellSize);
-    
-    // Calculate grid IDs for nearby cells
-    TArray<uint16> NearbyGrids;
-    NearbyGrids.Add(CenterGridId); // Add the center grid
-    
-    // Add grids surrounding the center (simplified)
-    // Note: In a real implementation, a more accurate neighbor calculation should be used
-    
-    // Convert the center grid ID into X, Y, Z coordinates from the hash
-    const int32 CenterX = (CenterGridId >> 10) & 0x3F;
-    const int32 CenterY = (CenterGridId >> 4) & 0x3F;
-    const int32 CenterZ = CenterGridId & 0xF;
+    Head = 0;
+    NumSamples = 0;
     
-    // Calculate neighboring grid cells
-    for (int32 dx = -GridRadius; dx <= GridRadius; ++dx)
+    for (FOutlier& Outlier : Outliers)
     {
-        for (int32 dy = -GridRadius; dy <= GridRadius; ++dy)
+        Outlier = FOutlier();
+    }
+}
+
+void FEnhancedTickBatchHistory::GetStats(uint64 CurrentFrame, FEnhancedTickBatchStats& OutStats) const
+{
+    // Until the ring wraps the valid samples are the first NumSamples slots
+    OutStats.NumFrames = NumSamples;
+    OutStats.BatchTimeMs = CalculateWindowPercentiles(BatchTimesMs.GetData(), NumSamples);
+    OutStats.EntityCostNs = CalculateWindowPercentiles(EntityCostsNs.GetData(), NumSamples);
+    OutStats.EntityCount = CalculateWindowPercentiles(EntityCounts.GetData(), NumSamples);
+    OutStats.CacheMissesPerEntity = CalculateWindowPercentiles(CacheMissesPerEntity.GetData(), NumSamples);
+    OutStats.InstructionsPerCycle = CalculateWindowPercentiles(InstructionsPerCycle.GetData(), NumSamples);
+    
+    OutStats.Outliers.Reset();
+    for (const FOutlier& Outlier : Outliers)
+    {
+        UObject* Object = Outlier.Object.Get();
+        if (Object && CurrentFrame - Outlier.Frame < NumFrames)
+        {
+            FEnhancedTickEntityOutlier& Entry = OutStats.Outliers.AddDefaulted_GetRef();
+            Entry.Object = Object;
+            Entry.CostUs = Outlier.CostNs * 1.0e-3f;
+            Entry.FramesAgo = int32(CurrentFrame - Outlier.Frame);
+        }
+    }
+    
+    OutStats.Outliers.Sort([](const FEnhancedTickEntityOutlier& A, const FEnhancedTickEntityOutlier& B)
+    {
+        return A.CostUs > B.CostUs;
+    });
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FComponentTypeBatch Implementation
+
+void FComponentTypeBatch::TickBatch(float DeltaTime)
+{
+    const uint64 WallStartCycles = FPlatformTime::Cycles64();
+    ON_SCOPE_EXIT
+    {
+        LastFrameWallCycles = FPlatformTime::Cycles64() - WallStartCycles;
+    };
+    
+    LastFrameTickCount = 0;
+    LastFrameDeferredCount = 0;
+    LastFrameCounters = FEnhancedTickHardwareCounters();
+    ChunkSamples.Reset();
+    
+    if (Entities.Num() == 0 || !BatchTickFunction)
+    {
+        return;
+    }
+    
+    // Sort for optimized tick processing if cache locality sorting is enabled
+    if (bSortByCacheLocality)
+    {
+        SortForCacheLocality();
+    }
+    
+    // The active set is maintained incrementally - tick straight from it (or from the LOD subset)
+    const TArrayView<const int32> ActiveIndices = GatherTickIndices(DeltaTime);
+    
+    if (ActiveIndices.Num() == 0)
+    {
+        Entities.bUseEntityDeltaTimes = false;
+        return;
+    }
+    
+    // Call the BatchTickFunction for all active objects
+    const double StartTime = FPlatformTime::Seconds();
+    
+    // Optimize cache usage using prefetch (load the first entity)
+    ENHANCED_TICK_PREFETCH_DATA(Entities.Objects[ActiveIndices[0]]);
+    
+    // Only batches whose settings ask for it hold a lock while ticking
+    if (BatchLock.IsValid())
+    {
+        FScopeLock Lock(BatchLock.Get());
+        TickIndicesSerial(ActiveIndices, DeltaTime);
+    }
+    else
+    {
+        TickIndicesSerial(ActiveIndices, DeltaTime);
+    }
+    Entities.bUseEntityDeltaTimes = false;
+    
+    // Update statistics
+    const double EndTime = FPlatformTime::Seconds();
+    AverageTickTimeNs = float((EndTime - StartTime) * 1.0e9) / ActiveIndices.Num();
+    LastFrameTickCount = ActiveIndices.Num();
+}
+
+
+void FComponentTypeBatch::TickBatchParallel(float DeltaTime)
+{
+    const uint64 WallStartCycles = FPlatformTime::Cycles64();
+    ON_SCOPE_EXIT
+    {
+        LastFrameWallCycles = FPlatformTime::Cycles64() - WallStartCycles;
+    };
+    
+    LastFrameTickCount = 0;
+    LastFrameDeferredCount = 0;
+    LastFrameCounters = FEnhancedTickHardwareCounters();
+    ChunkSamples.Reset();
+    
+    if (Entities.Num() == 0 || !BatchTickFunction || !CanTickInParallel())
+    {
+        TickBatch(DeltaTime);
+        return;
+    }
+    
+    // Sort entities if necessary
+    if (bSortByCacheLocality)
+    {
+        SortForCacheLocality();
+    }
+    
+    // Use the standard tick for thread-unsafe components (classified once per class)
+    if (MustTickOnGameThread())
+    {
+        TraceSchedulingDecision(EEnhancedTickTraceDecision::SerialFallback, TypeName, int32(EEnhancedTickSerialFallback::GameThreadOnly), Entities.NumActive());
+        TickBatch(DeltaTime);
+        return;
+    }
+    
+    // The active set is maintained incrementally - no filtering pass required unless the tick LOD is on
+    const TArrayView<const int32> ActiveIndices = GatherTickIndices(DeltaTime);
+    
+    if (ActiveIndices.Num() == 0)
+    {
+        Entities.bUseEntityDeltaTimes = false;
+        return;
+    }
+    
+    LastFrameTickCount = ActiveIndices.Num();
+    
+    // Run the chunks on the workers and the game thread; the per-entity average is CPU time, not wall time
+    const uint64 TotalCycles = TickIndicesParallel(ActiveIndices, DeltaTime);
+    Entities.bUseEntityDeltaTimes = false;
+    AverageTickTimeNs = float(FPlatformTime::ToSeconds64(TotalCycles) * 1.0e9) / ActiveIndices.Num();
+}
+
+bool FComponentTypeBatch::TickBatchAsync(float DeltaTime)
+{
+    LastFrameTickCount = 0;
+    LastFrameDeferredCount = 0;
+    LastFrameCounters = FEnhancedTickHardwareCounters();
+    ChunkSamples.Reset();
+    
+    if (Entities.Num() == 0 || !BatchTickFunction || !CanTickInParallel())
+    {
+        TickBatch(DeltaTime);
+        return false;
+    }
+    
+    if (bSortByCacheLocality)
+    {
+        SortForCacheLocality();
+    }
+    
+    // Entities that need the game thread cannot run while the game thread moves on;
+    // two-phase batches apply their commands at the join instead
+    if (MustTickOnGameThread())
+    {
+        TraceSchedulingDecision(EEnhancedTickTraceDecision::SerialFallback, TypeName, int32(EEnhancedTickSerialFallback::GameThreadOnly), Entities.NumActive());
+        TickBatch(DeltaTime);
+        return false;
+    }
+    
+    // The per-entity delta times stay in use until the join
+    const TArrayView<const int32> ActiveIndices = GatherTickIndices(DeltaTime);
+    if (ActiveIndices.Num() == 0)
+    {
+        Entities.bUseEntityDeltaTimes = false;
+        return false;
+    }
+    
+    LastFrameTickCount = ActiveIndices.Num();
+    
+    // All chunks go to the workers; a null task gathering the helpers becomes the completion event
+    FGraphEventArray HelperTasks;
+    AsyncTickState = LaunchParallelTick(ActiveIndices, DeltaTime, false, HelperTasks);
+    AsyncCompletionEvent = FFunctionGraphTask::CreateAndDispatchWhenReady([]() {}, TStatId(), &HelperTasks, ENamedThreads::AnyThread);
+    
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Two-phase command buffers
+
+void FEnhancedTickCommandBuffer::SetWorldLocationAndRotation(USceneComponent* Component, const FVector& Location, const FQuat& Rotation)
+{
+    FTransformCommand& Command = TransformCommands.AddDefaulted_GetRef();
+    Command.Component = Component;
+    Command.Location = Location;
+    Command.Rotation = Rotation;
+}
+
+void FEnhancedTickCommandBuffer::Defer(TFunction<void()>&& Command)
+{
+    DeferredCommands.Add(MoveTemp(Command));
+}
+
+void FEnhancedTickCommandBuffer::Apply()
+{
+    for (const FTransformCommand& Command : TransformCommands)
+    {
+        // The component may have been destroyed between the two phases
+        if (IsValid(Command.Component))
+        {
+            Command.Component->SetWorldLocationAndRotation(Command.Location, Command.Rotation);
+        }
+    }
+    
+    for (TFunction<void()>& Command : DeferredCommands)
+    {
+        Command();
+    }
+    
+    Reset();
+}
+
+void FEnhancedTickCommandBuffer::Reset()
+{
+    TransformCommands.Reset();
+    DeferredCommands.Reset();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Parallel chunk scheduling
+
+/**
+ * Shared state of one parallel tick. Participants claim chunks from NextChunk until none remain,
+ * so threads that draw cheap entities keep pulling work instead of idling behind the slowest chunk.
+ */
+struct FEnhancedParallelTickState
+{
+    const FEnhancedBatchTickFunction* Kernel;
+    
+    // Set for two-phase batches: chunks compute into CommandBuffers[Chunk] instead of calling Kernel
+    const FEnhancedBatchComputeFunction* ComputeKernel;
+    FEnhancedTickCommandBuffer* CommandBuffers;
+    
+    const FTickEntityStore* Store;
+    TArrayView<const int32> Indices;
+    float DeltaTime;
+    int32 GrainSize;
+    int32 NumChunks;
+    
+    // One timed entity per chunk, at an offset that rotates with the frame
+    FEnhancedTickEntitySample* Samples;
+    uint32 SampleSeed;
+    
+    // Name of the batch scope each participant opens in the trace
+    const TCHAR* BatchName;
+    
+    std::atomic<int32> NextChunk;
+    std::atomic<uint64> TotalCycles;
+    
+    // Hardware counters summed over the participants
+    std::atomic<uint64> CounterCycles;
+    std::atomic<uint64> CounterInstructions;
+    std::atomic<uint64> CounterCacheMisses;
+    
+    FEnhancedParallelTickState(const FEnhancedBatchTickFunction* InKernel, const FTickEntityStore* InStore, TArrayView<const int32> InIndices, float InDeltaTime, int32 InGrainSize)
+        : Kernel(InKernel)
+        , ComputeKernel(nullptr)
+        , CommandBuffers(nullptr)
+        , Store(InStore)
+        , Indices(InIndices)
+        , DeltaTime(InDeltaTime)
+        , GrainSize(InGrainSize)
+        , NumChunks(FMath::DivideAndRoundUp(InIndices.Num(), InGrainSize))
+        , Samples(nullptr)
+        , SampleSeed(0)
+        , BatchName(TEXT(""))
+        , NextChunk(0)
+        , TotalCycles(0)
+        , CounterCycles(0)
+        , CounterInstructions(0)
+        , CounterCacheMisses(0)
+    {}
+    
+    // Claim and tick chunks until the cursor runs past the end
+    void Run()
+    {
+        TRACE_CPUPROFILER_EVENT_SCOPE_TEXT_ON_CHANNEL(BatchName, EnhancedTickChannel);
+        const uint64 StartCycles = FPlatformTime::Cycles64();
+        const FEnhancedTickHardwareCounterScope CounterScope;
+        
+        for (int32 Chunk = NextChunk.fetch_add(1, std::memory_order_relaxed); Chunk < NumChunks;
+             Chunk = NextChunk.fetch_add(1, std::memory_order_relaxed))
+        {
+            TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("EnhancedTick Chunk", EnhancedTickChannel);
+            const int32 StartIdx = Chunk * GrainSize;
+            const int32 Count = FMath::Min(GrainSize, Indices.Num() - StartIdx);
+            
+            // Tick the claimed chunk with the batch kernel
+            auto TickRange = [this, Chunk](TArrayView<const int32> Range)
+            {
+                if (ComputeKernel)
+                {
+                    (*ComputeKernel)(*Store, Range, DeltaTime, CommandBuffers[Chunk]);
+                }
+                else
+                {
+                    (*Kernel)(*Store, Range, DeltaTime);
+                }
+            };
+            
+            if (Samples)
+            {
+                TickRangeWithSample(Indices.Slice(StartIdx, Count), int32((SampleSeed + uint32(Chunk)) % uint32(Count)), Samples[Chunk], TickRange);
+            }
+            else
+            {
+                TickRange(Indices.Slice(StartIdx, Count));
+            }
+        }
+        
+        TotalCycles.fetch_add(FPlatformTime::Cycles64() - StartCycles, std::memory_order_relaxed);
+        
+        if (CounterScope.bActive)
+        {
+            const FEnhancedTickHardwareCounters Counters = CounterScope.Stop();
+            CounterCycles.fetch_add(Counters.Cycles, std::memory_order_relaxed);
+            CounterInstructions.fetch_add(Counters.Instructions, std::memory_order_relaxed);
+            CounterCacheMisses.fetch_add(Counters.CacheMisses, std::memory_order_relaxed);
+        }
+    }
+    
+    FEnhancedTickHardwareCounters GetCounters() const
+    {
+        FEnhancedTickHardwareCounters Counters;
+        Counters.Cycles = CounterCycles.load();
+        Counters.Instructions = CounterInstructions.load();
+        Counters.CacheMisses = CounterCacheMisses.load();
+        return Counters;
+    }
+};
+
+void FComponentTypeBatch::WaitForAsyncTick()
+{
+    if (!AsyncCompletionEvent.IsValid())
+    {
+        return;
+    }
+    
+    // Help with whatever has not been claimed yet, then wait for the chunks in flight
+    if (AsyncTickState.IsValid())
+    {
+        AsyncTickState->Run();
+    }
+    
+    FTaskGraphInterface::Get().WaitUntilTaskCompletes(AsyncCompletionEvent);
+    
+    // Two-phase batches commit their writes at the join
+    if (AsyncTickState.IsValid() && AsyncTickState->ComputeKernel)
+    {
+        const uint64 ApplyStartCycles = FPlatformTime::Cycles64();
+        ApplyCommandBuffers(AsyncTickState->NumChunks);
+        AsyncTickState->TotalCycles.fetch_add(FPlatformTime::Cycles64() - ApplyStartCycles, std::memory_order_relaxed);
+    }
+    
+    Entities.bUseEntityDeltaTimes = false;
+    
+    if (AsyncTickState.IsValid() && LastFrameTickCount > 0)
+    {
+        AverageTickTimeNs = float(FPlatformTime::ToSeconds64(AsyncTickState->TotalCycles.load()) * 1.0e9) / LastFrameTickCount;
+        LastFrameCounters += AsyncTickState->GetCounters();
+    }
+    
+    AsyncCompletionEvent = nullptr;
+    AsyncTickState.Reset();
+}
+
+void FComponentTypeBatch::TickIndicesSerial(TArrayView<const int32> Indices, float DeltaTime)
+{
+    const FEnhancedTickHardwareCounterScope CounterScope;
+    
+    // One entity is timed on its own for the outlier tracking
+    ChunkSamples.SetNum(1);
+    const int32 SampleOffset = int32(GFrameCounter % uint64(Indices.Num()));
+    
+    if (IsTwoPhase())
+    {
+        if (ChunkCommandBuffers.Num() == 0)
+        {
+            ChunkCommandBuffers.AddDefaulted();
+        }
+        
+        ChunkCommandBuffers[0].Reset();
+        TickRangeWithSample(Indices, SampleOffset, ChunkSamples[0], [this, DeltaTime](TArrayView<const int32> Range)
+        {
+            BatchComputeFunction(Entities, Range, DeltaTime, ChunkCommandBuffers[0]);
+        });
+        ApplyCommandBuffers(1);
+    }
+    else
+    {
+        TickRangeWithSample(Indices, SampleOffset, ChunkSamples[0], [this, DeltaTime](TArrayView<const int32> Range)
+        {
+            BatchTickFunction(Entities, Range, DeltaTime);
+        });
+    }
+    
+    LastFrameCounters += CounterScope.Stop();
+}
+
+void FComponentTypeBatch::ApplyCommandBuffers(int32 NumChunks)
+{
+    check(IsInGameThread());
+    
+    for (int32 Chunk = 0; Chunk < NumChunks; ++Chunk)
+    {
+        ChunkCommandBuffers[Chunk].Apply();
+    }
+}
+
+void FComponentTypeBatch::RecordFrameHistory(uint64 FrameNumber)
+{
+    if (LastFrameTickCount > 0)
+    {
+        History.AddFrame(GetLastFrameTimeMs(), AverageTickTimeNs, LastFrameTickCount, LastFrameCounters);
+    }
+    
+    // Membership only changes at the start of the frame, so the sampled dense indices are still current
+    for (const FEnhancedTickEntitySample& Sample : ChunkSamples)
+    {
+        if (Entities.Objects.IsValidIndex(Sample.DenseIndex) && IsValid(Entities.Objects[Sample.DenseIndex]))
+        {
+            History.AddOutlier(Entities.Objects[Sample.DenseIndex], float(FPlatformTime::ToSeconds64(Sample.Cycles) * 1.0e9), FrameNumber);
+        }
+    }
+    
+    ChunkSamples.Reset();
+}
+
+void FComponentTypeBatch::BuildAdaptiveCandidates(bool bAllowParallel)
+{
+    FEnhancedTickAdaptiveState& State = Adaptive;
+    State = FEnhancedTickAdaptiveState();
+    State.bBuiltWithParallel = bAllowParallel;
+    
+    auto AddCandidate = [&State](const FEnhancedTickBatchMode& Mode)
+    {
+        for (int32 Index = 0; Index < State.NumCandidates; ++Index)
+        {
+            if (State.Candidates[Index] == Mode)
+            {
+                return;
+            }
+        }
+        if (State.NumCandidates < FEnhancedTickAdaptiveState::MaxCandidates)
+        {
+            State.ScoresNs[State.NumCandidates] = -1.0;
+            State.Candidates[State.NumCandidates++] = Mode;
+        }
+    };
+    
+    // The current configuration starts as the incumbent
+    AddCandidate(FEnhancedTickBatchMode(CanTickInParallel() && bAllowParallel, bSortByCacheLocality, ParallelGrainScale));
+    AddCandidate(FEnhancedTickBatchMode(false, true, 1.0f));
+    AddCandidate(FEnhancedTickBatchMode(false, false, 1.0f));
+    
+    if (bAllowParallel)
+    {
+        AddCandidate(FEnhancedTickBatchMode(true, true, 0.5f));
+        AddCandidate(FEnhancedTickBatchMode(true, true, 1.0f));
+        AddCandidate(FEnhancedTickBatchMode(true, true, 2.0f));
+        AddCandidate(FEnhancedTickBatchMode(true, false, 1.0f));
+    }
+    
+    ApplyBatchMode(State.Candidates[0]);
+}
+
+void FComponentTypeBatch::ApplyBatchMode(const FEnhancedTickBatchMode& Mode)
+{
+    if (Mode.bParallel)
+    {
+        Flags |= ETickBatchFlags::UseParallel;
+    }
+    else
+    {
+        Flags &= ~ETickBatchFlags::UseParallel;
+    }
+    
+    bSortByCacheLocality = Mode.bSorted;
+    ParallelGrainScale = Mode.GrainScale;
+}
+
+bool FComponentTypeBatch::UpdateAdaptiveMode(float& OutGainPercent)
+{
+    if (!Settings.bAdaptiveMode || Settings.bDeferredJoin || LastFrameTickCount == 0 || Entities.NumActive() < ENHANCED_TICK_ADAPTIVE_MIN_ENTITIES)
+    {
+        return false;
+    }
+    
+    // Parallel candidates need a kernel that may run off the game thread (directly or in two phases)
+    const bool bAllowParallel = !Settings.bNeverParallel && BatchTickFunction && (!bGameThreadOnly || IsTwoPhase());
+    
+    FEnhancedTickAdaptiveState& State = Adaptive;
+    if (State.NumCandidates == 0 || State.bBuiltWithParallel != bAllowParallel)
+    {
+        BuildAdaptiveCandidates(bAllowParallel);
+        return false;
+    }
+    
+    State.WindowCycles += LastFrameWallCycles;
+    State.WindowEntities += LastFrameTickCount;
+    if (++State.WindowFrames < ENHANCED_TICK_ADAPTIVE_WINDOW_FRAMES)
+    {
+        return false;
+    }
+    
+    // Wall time per entity, so windows with different LOD or budget shares stay comparable
+    const double WindowScore = FPlatformTime::ToSeconds64(State.WindowCycles) * 1.0e9 / double(FMath::Max<int64>(State.WindowEntities, 1));
+    double& Score = State.ScoresNs[State.Current];
+    Score = Score < 0.0 ? WindowScore : FMath::Lerp(Score, WindowScore, 0.5);
+    
+    State.WindowFrames = 0;
+    State.WindowCycles = 0;
+    State.WindowEntities = 0;
+    
+    // Between rounds the incumbent runs and keeps its score current
+    if (State.ExploreCursor == INDEX_NONE)
+    {
+        if (--State.WindowsUntilRound > 0)
+        {
+            return false;
+        }
+        State.ExploreCursor = 0;
+    }
+    
+    // Sample the next other candidate of the round
+    while (State.ExploreCursor < State.NumCandidates && State.ExploreCursor == State.Incumbent)
+    {
+        ++State.ExploreCursor;
+    }
+    
+    if (State.ExploreCursor < State.NumCandidates)
+    {
+        State.Current = State.ExploreCursor++;
+        ApplyBatchMode(State.Candidates[State.Current]);
+        return false;
+    }
+    
+    // Round complete: find the fastest candidate
+    int32 Best = State.Incumbent;
+    for (int32 Index = 0; Index < State.NumCandidates; ++Index)
+    {
+        if (State.ScoresNs[Index] >= 0.0 && State.ScoresNs[Index] < State.ScoresNs[Best])
+        {
+            Best = Index;
+        }
+    }
+    
+    bool bSwitched = false;
+    const double IncumbentScore = State.ScoresNs[State.Incumbent];
+    
+    if (Best != State.Incumbent && State.ScoresNs[Best] < IncumbentScore * (1.0 - ENHANCED_TICK_ADAPTIVE_MARGIN))
+    {
+        State.ChallengerWins = State.Challenger == Best ? State.ChallengerWins + 1 : 1;
+        State.Challenger = Best;
+        
+        if (State.ChallengerWins >= ENHANCED_TICK_ADAPTIVE_CONFIRMATIONS)
+        {
+            OutGainPercent = float((1.0 - State.ScoresNs[Best] / IncumbentScore) * 100.0);
+            State.Incumbent = Best;
+            State.Challenger = INDEX_NONE;
+            State.ChallengerWins = 0;
+            bSwitched = true;
+        }
+    }
+    else
+    {
+        State.Challenger = INDEX_NONE;
+        State.ChallengerWins = 0;
+    }
+    
+    // A pending challenger is confirmed in the very next round instead of after the full interval
+    State.ExploreCursor = INDEX_NONE;
+    State.WindowsUntilRound = State.Challenger != INDEX_NONE ? 1 : ENHANCED_TICK_ADAPTIVE_ROUND_INTERVAL;
+    State.Current = State.Incumbent;
+    ApplyBatchMode(State.Candidates[State.Incumbent]);
+    
+    return bSwitched;
+}
+
+bool FComponentTypeBatch::CanTickOffGameThread() const
+{
+    // The apply phase of a two-phase batch needs the game thread
+    return CanTickInParallel() && BatchTickFunction && !bGameThreadOnly && !IsTwoPhase();
+}
+
+int32 FComponentTypeBatch::CalculateParallelGrainSize(int32 NumEntities, int32 NumParticipants) const
+{
+    // At least a few chunks per participant so that stealing can even out skewed entity costs;
+    // the adaptive optimizer scales both bounds
+    const int32 MaxGrain = FMath::Max(1, FMath::TruncToInt(NumEntities * ParallelGrainScale / (NumParticipants * ENHANCED_TICK_MIN_CHUNKS_PER_THREAD)));
+    
+    // Without a measurement yet, fall back to the coarsest grain that still balances
+    if (AverageTickTimeNs <= 0.0f)
+    {
+        return MaxGrain;
+    }
+    
+    // Size chunks so that each one takes roughly the target time
+    const int32 MeasuredGrain = FMath::TruncToInt(ENHANCED_TICK_PARALLEL_CHUNK_TARGET_NS * ParallelGrainScale / AverageTickTimeNs);
+    return FMath::Clamp(MeasuredGrain, 1, MaxGrain);
+}
+
+TSharedRef<FEnhancedParallelTickState> FComponentTypeBatch::LaunchParallelTick(TArrayView<const int32> Indices, float DeltaTime, bool bCallerParticipates, FGraphEventArray& OutHelperTasks)
+{
+    // Determine the number of worker threads available to this world
+    UEnhancedTickScheduler* Scheduler = LODFrame ? LODFrame->Scheduler : nullptr;
+    const int32 NumWorkers = Scheduler ? FMath::Min(FTaskGraphInterface::Get().GetNumWorkerThreads(), LODFrame->WorkerShare) : FTaskGraphInterface::Get().GetNumWorkerThreads();
+    const int32 NumParticipants = NumWorkers + (bCallerParticipates ? 1 : 0);
+    const int32 GrainSize = CalculateParallelGrainSize(Indices.Num(), FMath::Max(1, NumParticipants));
+    
+    TSharedRef<FEnhancedParallelTickState> State = MakeShared<FEnhancedParallelTickState>(&BatchTickFunction, &Entities, Indices, DeltaTime, GrainSize);
+    
+    // Two-phase batches compute into one command buffer per chunk
+    if (IsTwoPhase())
+    {
+        if (ChunkCommandBuffers.Num() < State->NumChunks)
+        {
+            ChunkCommandBuffers.SetNum(State->NumChunks);
+        }
+        
+        for (int32 Chunk = 0; Chunk < State->NumChunks; ++Chunk)
+        {
+            ChunkCommandBuffers[Chunk].Reset();
+        }
+        
+        State->ComputeKernel = &BatchComputeFunction;
+        State->CommandBuffers = ChunkCommandBuffers.GetData();
+    }
+    
+    // Every chunk times one of its entities
+    ChunkSamples.SetNum(State->NumChunks);
+    State->Samples = ChunkSamples.GetData();
+    State->SampleSeed = uint32(GFrameCounter);
+    State->BatchName = *TypeName;
+    
+    // Use TaskGraph for the helpers; no more helpers than there are chunks to share
+    int32 NumHelpers = FMath::Max(1, FMath::Min(NumWorkers, State->NumChunks - (bCallerParticipates ? 1 : 0)));
+    
+    // Worker slots are shared with the other worlds; a caller that participates can do without helpers,
+    // an asynchronous tick needs at least one. Chunks are claimed dynamically, so fewer helpers only take longer.
+    if (Scheduler)
+    {
+        NumHelpers = Scheduler->AcquireWorkers(NumHelpers, bCallerParticipates ? 0 : 1);
+    }
+    OutHelperTasks.Reserve(NumHelpers);
+    
+    for (int32 HelperIdx = 0; HelperIdx < NumHelpers; ++HelperIdx)
+    {
+        OutHelperTasks.Add(FFunctionGraphTask::CreateAndDispatchWhenReady([State, Scheduler]()
+        {
+            State->Run();
+            
+            if (Scheduler)
+            {
+                Scheduler->ReleaseWorkers(1);
+            }
+        }, TStatId(), nullptr, ENamedThreads::AnyThread));
+    }
+    
+    return State;
+}
+
+uint64 FComponentTypeBatch::TickIndicesParallel(TArrayView<const int32> Indices, float DeltaTime)
+{
+    if (Indices.Num() == 0)
+    {
+        return 0;
+    }
+    
+    FGraphEventArray HelperTasks;
+    TSharedRef<FEnhancedParallelTickState> State = LaunchParallelTick(Indices, DeltaTime, true, HelperTasks);
+    
+    // The calling thread works instead of blocking
+    State->Run();
+    
+    // Only the chunks still in flight on the helpers remain at this point
+    FTaskGraphInterface::Get().WaitUntilTasksComplete(HelperTasks);
+    
+    if (State->ComputeKernel)
+    {
+        const uint64 ApplyStartCycles = FPlatformTime::Cycles64();
+        ApplyCommandBuffers(State->NumChunks);
+        State->TotalCycles.fetch_add(FPlatformTime::Cycles64() - ApplyStartCycles, std::memory_order_relaxed);
+    }
+    
+    LastFrameCounters += State->GetCounters();
+    return State->TotalCycles.load();
+}
+
+void FComponentTypeBatch::SortForCacheLocality()
+{
+    // Only re-sort when membership changed or an entity moved into another sort cell
+    if (!Entities.bOrderDirty)
+    {
+        return;
+    }
+    
+    Entities.bOrderDirty = false;
+    
+    const int32 Num = Entities.Num();
+    if (Num < 2)
+    {
+        return;
+    }
+    
+    // Sort (Morton key, dense index) pairs - linear time radix sort
+    SortScratchKeys = Entities.SortKeys;
+    SortScratchOrder.SetNumUninitialized(Num, false);
+    for (int32 i = 0; i < Num; ++i)
+    {
+        SortScratchOrder[i] = i;
+    }
+    
+    RadixSortByKey(SortScratchKeys, SortScratchOrder, SortTempKeys, SortTempOrder);
+    
+    // Reorder the storage in place; the radix sort is done with its temporary arrays
+    Entities.ApplyPermutation(SortScratchOrder, SortTempOrder, SortTempLocations);
+}
+
+void FComponentTypeBatch::GatherEntityPositions(TArray<int32>& OutMovers)
+{
+    const TArrayView<const int32> ActiveIndices = Entities.GetActiveIndices();
+    if (ActiveIndices.Num() == 0)
+    {
+        return;
+    }
+    
+    // The class of a batch is exact, so the location accessor is picked once
+    const bool bActors = BatchClass && BatchClass->IsChildOf<AActor>();
+    const bool bSceneComponents = BatchClass && BatchClass->IsChildOf<USceneComponent>();
+    
+    const int32 NumChunks = FMath::DivideAndRoundUp(ActiveIndices.Num(), ENHANCED_TICK_POSITION_GATHER_CHUNK);
+    if (ChunkMovers.Num() < NumChunks)
+    {
+        ChunkMovers.SetNum(NumChunks);
+    }
+    
+    // Locations are only read while the game thread waits; each chunk writes its own slice of the position column
+    // and records its movers separately
+    ParallelFor(NumChunks, [this, ActiveIndices, bActors, bSceneComponents](int32 Chunk)
+    {
+        TArray<int32>& Movers = ChunkMovers[Chunk];
+        Movers.Reset();
+        
+        const int32 Start = Chunk * ENHANCED_TICK_POSITION_GATHER_CHUNK;
+        const int32 End = FMath::Min(Start + ENHANCED_TICK_POSITION_GATHER_CHUNK, ActiveIndices.Num());
+        
+        for (int32 i = Start; i < End; ++i)
+        {
+            const int32 DenseIndex = ActiveIndices[i];
+            UObject* Object = Entities.Objects[DenseIndex];
+            if (!IsValid(Object))
+            {
+                continue;
+            }
+            
+            FVector Position;
+            if (bActors)
+            {
+                Position = static_cast<AActor*>(Object)->GetActorLocation();
+            }
+            else if (bSceneComponents)
+            {
+                Position = static_cast<USceneComponent*>(Object)->GetComponentLocation();
+            }
+            else if (const AActor* Owner = static_cast<UActorComponent*>(Object)->GetOwner())
+            {
+                Position = Owner->GetActorLocation();
+            }
+            else
+            {
+                continue;
+            }
+            
+            if (Position != Entities.Positions[DenseIndex])
+            {
+                Entities.Positions[DenseIndex] = Position;
+                Movers.Add(DenseIndex);
+            }
+        }
+    }, NumChunks < 2);
+    
+    for (int32 Chunk = 0; Chunk < NumChunks; ++Chunk)
+    {
+        OutMovers.Append(ChunkMovers[Chunk]);
+    }
+}
+
+void FComponentTypeBatch::GetMemoryFootprint(FEnhancedTickBatchMemory& OutMemory) const
+{
+    OutMemory.BatchClass = BatchClass;
+    OutMemory.NumEntities = Entities.Num();
+    OutMemory.EntityBytes = Entities.GetAllocatedSize();
+    
+    SIZE_T ScratchBytes = SortScratchKeys.GetAllocatedSize() + SortScratchOrder.GetAllocatedSize() + SortTempKeys.GetAllocatedSize()
+        + SortTempOrder.GetAllocatedSize() + SortTempLocations.GetAllocatedSize() + LODTickIndices.GetAllocatedSize() + BudgetTickIndices.GetAllocatedSize()
+        + ChunkCommandBuffers.GetAllocatedSize() + ChunkMovers.GetAllocatedSize() + ChunkSamples.GetAllocatedSize()
+        + ClientCellDistancesSq.GetAllocatedSize();
+    
+    for (const FEnhancedTickCommandBuffer& Commands : ChunkCommandBuffers)
+    {
+        ScratchBytes += Commands.GetAllocatedSize();
+    }
+    for (const TArray<int32>& Movers : ChunkMovers)
+    {
+        ScratchBytes += Movers.GetAllocatedSize();
+    }
+    
+    OutMemory.ScratchBytes = ScratchBytes;
+    OutMemory.BatchBytes = sizeof(FComponentTypeBatch) + TypeName.GetAllocatedSize() + Settings.LODBands.GetAllocatedSize();
+    OutMemory.TotalBytes = OutMemory.EntityBytes + OutMemory.ScratchBytes + OutMemory.BatchBytes;
+    
+    // Per allocated entity rather than per registered one, since that is what a larger population costs
+    const int32 Capacity = FMath::Max(Entities.Objects.Max(), 1);
+    OutMemory.BytesPerEntity = float(OutMemory.TotalBytes) / Capacity;
+}
+
+void FComponentTypeBatch::ApplySettings(const FEnhancedTickBatchSettings& InSettings)
+{
+    Settings = InSettings;
+    
+    // The lock only exists for batches that ask for it
+    if (!Settings.bLockTicks)
+    {
+        BatchLock.Reset();
+    }
+    else if (!BatchLock.IsValid())
+    {
+        BatchLock = MakeShared<FCriticalSection>();
+    }
+}
+
+int32 FComponentTypeBatch::GetLODTickInterval(const FVector& Position) const
+{
+    float MinDistanceSq = MAX_flt;
+    for (const FVector& ViewLocation : LODFrame->ViewLocations)
+    {
+        const float DistanceSq = LODFrame->Grid ? LODFrame->Grid->GetCellDistanceSquared(Position, ViewLocation) : float(FVector::DistSquared(Position, ViewLocation));
+        MinDistanceSq = FMath::Min(MinDistanceSq, DistanceSq);
+    }
+    
+    // Bands are kept sorted by distance
+    for (const FEnhancedTickLODBand& Band : Settings.LODBands)
+    {
+        if (MinDistanceSq <= FMath::Square(Band.MaxDistance))
+        {
+            return FMath::Max(1, Band.TickInterval);
+        }
+    }
+    
+    return FMath::Max(1, Settings.LODFarTickInterval);
+}
+
+TArrayView<const int32> FComponentTypeBatch::GatherTickIndices(float DeltaTime)
+{
+    Entities.bUseEntityDeltaTimes = false;
+    LastFrameDeferredCount = 0;
+    
+    TArrayView<const int32> TickIndices = Entities.GetActiveIndices();
+    
+    // Batches that are not owned by a system tick every frame with the frame delta
+    if (!LODFrame)
+    {
+        return TickIndices;
+    }
+    
+    // Low priority batches tick each entity every few frames; without viewers the LOD is off
+    const int32 LowPrioInterval = EnumHasAnyFlags(Flags, ETickBatchFlags::LowPrio) ? FMath::Max(1, Settings.LowPriorityTickInterval) : 1;
+    const bool bUseLOD = Settings.IsTickLODEnabled() && LODFrame->ViewLocations.Num() > 0;
+    
+    // On servers, entities out of net relevancy range of every player slow down (all of them while nobody is connected)
+    const int32 IrrelevantInterval = FMath::Max(1, Settings.IrrelevantTickInterval);
+    const bool bUseRelevancy = LODFrame->bIsServer && LODFrame->Grid && IrrelevantInterval > 1 && !EnumHasAnyFlags(Flags, ETickBatchFlags::HighPrio);
+    
+    if (bUseLOD || LowPrioInterval > 1 || bUseRelevancy || SkipFunction)
+    {
+        LODTickIndices.Reset(TickIndices.Num());
+        ClientCellDistancesSq.Reset();
+        int32 NumTierChanges = 0;
+        
+        for (const int32 DenseIndex : TickIndices)
+        {
+            int32 Interval = bUseLOD ? FMath::Max(LowPrioInterval, GetLODTickInterval(Entities.Positions[DenseIndex])) : LowPrioInterval;
+            if (bUseRelevancy && GetClientDistanceSquared(DenseIndex) > Entities.RelevancyDistancesSq[DenseIndex])
+            {
+                Interval = FMath::Max(Interval, IrrelevantInterval);
+            }
+            
+            // Tier changes are only counted for the trace; the first interval of an entity is not a change
+            int32& LastInterval = Entities.LODIntervals[DenseIndex];
+            NumTierChanges += (LastInterval != 0 && LastInterval != Interval) ? 1 : 0;
+            LastInterval = Interval;
+            
+            // The slot index gives each entity a stable phase, so an interval of N ticks 1/N of the entities every frame
+            const bool bDue = Interval == 1 || ((LODFrame->FrameNumber + Entities.DenseToSlot[DenseIndex]) % Interval) == 0;
+            
+            // Skipped entities are not stamped below, so they get the skipped time with their next tick
+            if (bDue && !(SkipFunction && SkipFunction(Entities, DenseIndex, LODFrame->FrameNumber)))
+            {
+                LODTickIndices.Add(DenseIndex);
+            }
+        }
+        
+        if (NumTierChanges > 0)
+        {
+            TraceSchedulingDecision(EEnhancedTickTraceDecision::LODTierChange, TypeName, NumTierChanges, TickIndices.Num());
+        }
+        
+        TickIndices = LODTickIndices;
+    }
+    
+    // Over budget: tick the due entities that waited longest, the rest carries over
+    if (TickBudgetEntities != INDEX_NONE && TickBudgetEntities < TickIndices.Num())
+    {
+        BudgetTickIndices.Reset(TickIndices.Num());
+        BudgetTickIndices.Append(TickIndices.GetData(), TickIndices.Num());
+        KeepOldestTicks(BudgetTickIndices, TickBudgetEntities, [this](int32 DenseIndex) { return Entities.LastTickTimes[DenseIndex]; });
+        
+        LastFrameDeferredCount = TickIndices.Num() - TickBudgetEntities;
+        TickIndices = BudgetTickIndices;
+        
+        TraceSchedulingDecision(EEnhancedTickTraceDecision::BudgetOverrun, TypeName, LastFrameDeferredCount, TickBudgetEntities);
+    }
+    
+    // Tick times are always tracked, so an entity gets the true time since its last tick
+    // however it was held back (LOD, low priority phase, budget)
+    const double Now = LODFrame->SimulationTime;
+    for (const int32 DenseIndex : TickIndices)
+    {
+        const double LastTickTime = Entities.LastTickTimes[DenseIndex];
+        Entities.EntityDeltaTimes[DenseIndex] = LastTickTime >= 0.0 ? float(Now - LastTickTime) : DeltaTime;
+        Entities.LastTickTimes[DenseIndex] = Now;
+    }
+    
+    Entities.bUseEntityDeltaTimes = true;
+    return TickIndices;
+}
+
+float FComponentTypeBatch::GetClientDistanceSquared(int32 DenseIndex)
+{
+    // Entities of a cell share the answer, so each occupied cell is measured against the player views once
+    const uint64 CellKey = Entities.SpatialBucketIds[DenseIndex];
+    if (const float* Cached = ClientCellDistancesSq.Find(CellKey))
+    {
+        return *Cached;
+    }
+    
+    // The gap between the cell and a view is a lower bound of the distance of every entity in the cell,
+    // so the throttling never reaches an entity within relevancy range of a player
+    const FSpatialEntityBatch& Grid = *LODFrame->Grid;
+    const FVector CellOrigin = Grid.GetCellOrigin(CellKey);
+    const FBox CellBounds(CellOrigin, CellOrigin + FVector(Grid.GridCellSize));
+    
+    float MinDistanceSq = MAX_flt;
+    for (const FVector& ViewLocation : LODFrame->ViewLocations)
+    {
+        MinDistanceSq = FMath::Min(MinDistanceSq, float(CellBounds.ComputeSquaredDistanceToPoint(ViewLocation)));
+    }
+    
+    ClientCellDistancesSq.Add(CellKey, MinDistanceSq);
+    return MinDistanceSq;
+}
+
+void FComponentTypeBatch::UpdateEntityPosition(int32 DenseIndex, const FVector& NewPosition)
+{
+    Entities.Positions[DenseIndex] = NewPosition;
+    
+    const uint64 NewKey = CalculateSortKey(NewPosition);
+    if (NewKey != Entities.SortKeys[DenseIndex])
+    {
+        Entities.SortKeys[DenseIndex] = NewKey;
+        Entities.bOrderDirty = true;
+    }
+}
+
+uint64 FComponentTypeBatch::CalculateSortKey(const FVector& Position) const
+{
+    // Quantize each axis and shift it into the unsigned Morton range
+    constexpr int64 AxisOffset = 1ll << (ENHANCED_TICK_MORTON_BITS - 1);
+    constexpr int64 AxisMax = (1ll << ENHANCED_TICK_MORTON_BITS) - 1;
+    
+    const double InvCellSize = 1.0 / FMath::Max(CacheSortCellSize, 1.0f);
+    const uint64 CellX = (uint64)FMath::Clamp<int64>(FMath::FloorToInt64(Position.X * InvCellSize) + AxisOffset, 0, AxisMax);
+    const uint64 CellY = (uint64)FMath::Clamp<int64>(FMath::FloorToInt64(Position.Y * InvCellSize) + AxisOffset, 0, AxisMax);
+    const uint64 CellZ = (uint64)FMath::Clamp<int64>(FMath::FloorToInt64(Position.Z * InvCellSize) + AxisOffset, 0, AxisMax);
+    
+    return SpreadMortonBits(CellX) | (SpreadMortonBits(CellY) << 1) | (SpreadMortonBits(CellZ) << 2);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FSpatialEntityBatch Implementation
+
+void FSpatialEntityBatch::Configure(float InGridCellSize, int32 InNumHierarchyLevels)
+{
+    if (!IsEmpty())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("EnhancedTickSystem: The spatial grid can only be configured while it is empty"));
+        return;
+    }
+    
+    GridCellSize = FMath::Max(InGridCellSize, 1.0f);
+    NumHierarchyLevels = FMath::Clamp(InNumHierarchyLevels, 0, ENHANCED_TICK_MAX_GRID_LEVELS);
+    LevelCounts.Reset();
+    LevelCounts.SetNum(NumHierarchyLevels);
+}
+
+void FSpatialEntityBatch::Empty()
+{
+    EntryRefs.Empty();
+    EntryX.Empty();
+    EntryY.Empty();
+    EntryZ.Empty();
+    Cells.Empty();
+    CellLookup.Empty();
+    
+    // Keep one map per configured level
+    for (TMap<FCellKey, int32>& Counts : LevelCounts)
+    {
+        Counts.Empty();
+    }
+    
+    NumSpatialEntities = 0;
+    NumWastedEntries = 0;
+}
+
+SIZE_T FSpatialEntityBatch::GetAllocatedSize() const
+{
+    SIZE_T Size = EntryRefs.GetAllocatedSize() + EntryX.GetAllocatedSize() + EntryY.GetAllocatedSize() + EntryZ.GetAllocatedSize()
+        + Cells.GetAllocatedSize() + CellLookup.GetAllocatedSize() + LevelCounts.GetAllocatedSize();
+    
+    for (const TMap<FCellKey, int32>& Counts : LevelCounts)
+    {
+        Size += Counts.GetAllocatedSize();
+    }
+    return Size;
+}
+
+FIntVector FSpatialEntityBatch::GetCellCoordinates(const FVector& Position) const
+{
+    constexpr double AxisLimit = double(1 << (CellAxisBits - 1)) - 1.0;
+    const double InvCellSize = 1.0 / GridCellSize;
+    
+    // Clamped so the coordinates always fit a key
+    return FIntVector(
+        int32(FMath::Clamp(FMath::FloorToDouble(Position.X * InvCellSize), -AxisLimit, AxisLimit)),
+        int32(FMath::Clamp(FMath::FloorToDouble(Position.Y * InvCellSize), -AxisLimit, AxisLimit)),
+        int32(FMath::Clamp(FMath::FloorToDouble(Position.Z * InvCellSize), -AxisLimit, AxisLimit)));
+}
+
+FSpatialEntityBatch::FCellKey FSpatialEntityBatch::MakeCellKey(const FIntVector& Coordinates, int32 Level)
+{
+    constexpr uint64 AxisMask = (1ull << CellAxisBits) - 1;
+    constexpr int32 AxisBias = 1 << (CellAxisBits - 1);
+    
+    return (uint64(Level) << (3 * CellAxisBits))
+        | ((uint64(Coordinates.X + AxisBias) & AxisMask) << (2 * CellAxisBits))
+        | ((uint64(Coordinates.Y + AxisBias) & AxisMask) << CellAxisBits)
+        | (uint64(Coordinates.Z + AxisBias) & AxisMask);
+}
+
+FIntVector FSpatialEntityBatch::GetKeyCoordinates(FCellKey Key)
+{
+    constexpr uint64 AxisMask = (1ull << CellAxisBits) - 1;
+    constexpr int32 AxisBias = 1 << (CellAxisBits - 1);
+    
+    return FIntVector(
+        int32((Key >> (2 * CellAxisBits)) & AxisMask) - AxisBias,
+        int32((Key >> CellAxisBits) & AxisMask) - AxisBias,
+        int32(Key & AxisMask) - AxisBias);
+}
+
+FSpatialEntityBatch::FCellKey FSpatialEntityBatch::CalculateGridCell(const FVector& Position) const
+{
+    return MakeCellKey(GetCellCoordinates(Position));
+}
+
+float FSpatialEntityBatch::GetCellDistanceSquared(const FVector& A, const FVector& B) const
+{
+    const FIntVector CellA = GetCellCoordinates(A);
+    const FIntVector CellB = GetCellCoordinates(B);
+    
+    return float(FVector(CellA - CellB).SizeSquared() * FMath::Square(GridCellSize));
+}
+
+FSpatialEntityBatch::FCellKey FSpatialEntityBatch::AddEntity(const FSpatialEntityRef& Ref, const FVector& Position)
+{
+    // Calculate grid cell
+    const FIntVector Coordinates = GetCellCoordinates(Position);
+    const FCellKey GridCell = MakeCellKey(Coordinates);
+    
+    int32 CellIndex;
+    if (const int32* ExistingIndex = CellLookup.Find(GridCell))
+    {
+        CellIndex = *ExistingIndex;
+    }
+    else
+    {
+        // A new cell gets a small range at the end of the pool
+        CellIndex = Cells.Add(FGridCell{ GridCell, AllocateEntries(ENHANCED_TICK_GRID_CELL_CAPACITY), 0, ENHANCED_TICK_GRID_CELL_CAPACITY });
+        CellLookup.Add(GridCell, CellIndex);
+    }
+    
+    if (Cells[CellIndex].Num == Cells[CellIndex].Capacity)
+    {
+        GrowCell(Cells[CellIndex]);
+    }
+    
+    // Add to grid cell
+    FGridCell& Cell = Cells[CellIndex];
+    SetEntry(Cell.Start + Cell.Num++, Cell, Ref, Position);
+    NumSpatialEntities++;
+    
+    UpdateLevelCounts(Coordinates, 1);
+    
+    return GridCell;
+}
+
+void FSpatialEntityBatch::RemoveEntity(const FSpatialEntityRef& Ref, FCellKey GridCell)
+{
+    const int32* CellIndexPtr = CellLookup.Find(GridCell);
+    if (!CellIndexPtr)
+    {
+        return;
+    }
+    
+    const int32 CellIndex = *CellIndexPtr;
+    FGridCell& Cell = Cells[CellIndex];
+    
+    // Remove from grid cell (swap with the last entry of the range)
+    const int32 EntryIndex = FindEntry(Cell, Ref);
+    if (EntryIndex != INDEX_NONE)
+    {
+        const int32 LastEntry = Cell.Start + Cell.Num - 1;
+        if (EntryIndex != LastEntry)
+        {
+            CopyEntries(LastEntry, EntryIndex, 1);
+        }
+        Cell.Num--;
+        NumSpatialEntities--;
+        UpdateLevelCounts(GetKeyCoordinates(GridCell), -1);
+    }
+    
+    if (Cell.Num == 0)
+    {
+        // Its range becomes unused; the last cell takes its place in the cell list
+        NumWastedEntries += Cell.Capacity;
+        CellLookup.Remove(GridCell);
+        
+        const int32 LastIndex = Cells.Num() - 1;
+        if (CellIndex != LastIndex)
+        {
+            Cells[CellIndex] = Cells[LastIndex];
+            CellLookup[Cells[CellIndex].Key] = CellIndex;
+        }
+        Cells.RemoveAt(LastIndex, 1, false);
+        
+        if (Cells.Num() == 0)
+        {
+            EntryRefs.Reset();
+            EntryX.Reset();
+            EntryY.Reset();
+            EntryZ.Reset();
+            NumWastedEntries = 0;
+        }
+    }
+}
+
+FSpatialEntityBatch::FCellKey FSpatialEntityBatch::MoveEntity(const FSpatialEntityRef& Ref, FCellKey GridCell, const FVector& NewPosition)
+{
+    // Entities the grid does not track still get the cell of their new position
+    const FCellKey NewCell = CalculateGridCell(NewPosition);
+    
+    const int32* CellIndex = CellLookup.Find(GridCell);
+    if (!CellIndex)
+    {
+        return NewCell;
+    }
+    
+    const FGridCell& Cell = Cells[*CellIndex];
+    const int32 EntryIndex = FindEntry(Cell, Ref);
+    if (EntryIndex == INDEX_NONE)
+    {
+        return NewCell;
+    }
+    
+    // Still in the same cell: only the position used by queries changes
+    if (NewCell == GridCell)
+    {
+        SetEntry(EntryIndex, Cell, Ref, NewPosition);
+        return GridCell;
+    }
+    
+    // Crossed into another cell: migrate
+    RemoveEntity(Ref, GridCell);
+    return AddEntity(Ref, NewPosition);
+}
+
+int32 FSpatialEntityBatch::AllocateEntries(int32 Num)
+{
+    const int32 Start = EntryRefs.Num();
+    EntryRefs.AddDefaulted(Num);
+    EntryX.AddZeroed(Num);
+    EntryY.AddZeroed(Num);
+    EntryZ.AddZeroed(Num);
+    return Start;
+}
+
+void FSpatialEntityBatch::CopyEntries(int32 From, int32 To, int32 Num)
+{
+    FMemory::Memcpy(EntryRefs.GetData() + To, EntryRefs.GetData() + From, Num * sizeof(FSpatialEntityRef));
+    FMemory::Memcpy(EntryX.GetData() + To, EntryX.GetData() + From, Num * sizeof(float));
+    FMemory::Memcpy(EntryY.GetData() + To, EntryY.GetData() + From, Num * sizeof(float));
+    FMemory::Memcpy(EntryZ.GetData() + To, EntryZ.GetData() + From, Num * sizeof(float));
+}
+
+void FSpatialEntityBatch::SetEntry(int32 EntryIndex, const FGridCell& Cell, const FSpatialEntityRef& Ref, const FVector& Position)
+{
+    // Relative to the cell origin the lanes stay small, so floats keep full precision anywhere in the world
+    const FVector Local = Position - GetCellOrigin(Cell.Key);
+    
+    EntryRefs[EntryIndex] = Ref;
+    EntryX[EntryIndex] = float(Local.X);
+    EntryY[EntryIndex] = float(Local.Y);
+    EntryZ[EntryIndex] = float(Local.Z);
+}
+
+int32 FSpatialEntityBatch::FindEntry(const FGridCell& Cell, const FSpatialEntityRef& Ref) const
+{
+    for (int32 EntryIndex = Cell.Start; EntryIndex < Cell.Start + Cell.Num; ++EntryIndex)
+    {
+        if (EntryRefs[EntryIndex] == Ref)
+        {
+            return EntryIndex;
+        }
+    }
+    return INDEX_NONE;
+}
+
+void FSpatialEntityBatch::GrowCell(FGridCell& Cell)
+{
+    const int32 NewCapacity = Cell.Capacity * 2;
+    const int32 NewStart = AllocateEntries(NewCapacity);
+    
+    CopyEntries(Cell.Start, NewStart, Cell.Num);
+    
+    NumWastedEntries += Cell.Capacity;
+    Cell.Start = NewStart;
+    Cell.Capacity = NewCapacity;
+    
+    // Amortized: the pool is repacked only once most of it is unused
+    if (NumWastedEntries > EntryRefs.Num() / 2)
+    {
+        CompactPool();
+    }
+}
+
+void FSpatialEntityBatch::CompactPool()
+{
+    const int32 NewPoolSize = EntryRefs.Num() - NumWastedEntries;
+    
+    TArray<FSpatialEntityRef> NewRefs;
+    TArray<float> NewX, NewY, NewZ;
+    NewRefs.Reserve(NewPoolSize);
+    NewX.Reserve(NewPoolSize);
+    NewY.Reserve(NewPoolSize);
+    NewZ.Reserve(NewPoolSize);
+    
+    // Capacities stay multiples of four, so the new ranges stay register-sized as well
+    for (FGridCell& Cell : Cells)
+    {
+        const int32 NewStart = NewRefs.Num();
+        NewRefs.Append(EntryRefs.GetData() + Cell.Start, Cell.Capacity);
+        NewX.Append(EntryX.GetData() + Cell.Start, Cell.Capacity);
+        NewY.Append(EntryY.GetData() + Cell.Start, Cell.Capacity);
+        NewZ.Append(EntryZ.GetData() + Cell.Start, Cell.Capacity);
+        Cell.Start = NewStart;
+    }
+    
+    EntryRefs = MoveTemp(NewRefs);
+    EntryX = MoveTemp(NewX);
+    EntryY = MoveTemp(NewY);
+    EntryZ = MoveTemp(NewZ);
+    NumWastedEntries = 0;
+}
+
+void FSpatialEntityBatch::UpdateLevelCounts(const FIntVector& Coordinates, int32 Delta)
+{
+    for (int32 Level = 1; Level <= NumHierarchyLevels; ++Level)
+    {
+        // Arithmetic shifts floor negative coordinates as well
+        const FIntVector Coarse(Coordinates.X >> Level, Coordinates.Y >> Level, Coordinates.Z >> Level);
+        const FCellKey CoarseKey = MakeCellKey(Coarse, Level);
+        
+        TMap<FCellKey, int32>& Counts = LevelCounts[Level - 1];
+        int32& Count = Counts.FindOrAdd(CoarseKey);
+        Count += Delta;
+        if (Count <= 0)
+        {
+            Counts.Remove(CoarseKey);
+        }
+    }
+}
+
+template<typename TVisitor>
+void FSpatialEntityBatch::ForEachCellInRange(const FIntVector& MinCell, const FIntVector& MaxCell, TVisitor&& Visitor) const
+{
+    const int64 RangeCells = int64(MaxCell.X - MinCell.X + 1) * (MaxCell.Y - MinCell.Y + 1) * (MaxCell.Z - MinCell.Z + 1);
+    
+    auto VisitCell = [this, &Visitor](const FIntVector& Coordinates)
+    {
+        if (const int32* CellIndex = CellLookup.Find(MakeCellKey(Coordinates)))
+        {
+            Visitor(*CellIndex);
+        }
+    };
+    
+    if (NumHierarchyLevels > 0)
+    {
+        // Descend from the coarsest level, only into occupied coarse cells
+        struct FPendingCell { FIntVector Coordinates; int32 Level; };
+        TArray<FPendingCell, TInlineAllocator<64>> Stack;
+        
+        const int32 TopLevel = NumHierarchyLevels;
+        for (int32 X = MinCell.X >> TopLevel; X <= MaxCell.X >> TopLevel; ++X)
+        {
+            for (int32 Y = MinCell.Y >> TopLevel; Y <= MaxCell.Y >> TopLevel; ++Y)
+            {
+                for (int32 Z = MinCell.Z >> TopLevel; Z <= MaxCell.Z >> TopLevel; ++Z)
+                {
+                    Stack.Add(FPendingCell{ FIntVector(X, Y, Z), TopLevel });
+                }
+            }
+        }
+        
+        while (Stack.Num() > 0)
+        {
+            const FPendingCell Pending = Stack.Pop(false);
+            if (Pending.Level == 0)
+            {
+                VisitCell(Pending.Coordinates);
+                continue;
+            }
+            
+            if (!LevelCounts[Pending.Level - 1].Contains(MakeCellKey(Pending.Coordinates, Pending.Level)))
+            {
+                continue;
+            }
+            
+            // Children of the coarse cell that overlap the range one level down
+            const int32 ChildLevel = Pending.Level - 1;
+            const FIntVector ChildMin(MinCell.X >> ChildLevel, MinCell.Y >> ChildLevel, MinCell.Z >> ChildLevel);
+            const FIntVector ChildMax(MaxCell.X >> ChildLevel, MaxCell.Y >> ChildLevel, MaxCell.Z >> ChildLevel);
+            
+            for (int32 Child = 0; Child < 8; ++Child)
+            {
+                const FIntVector ChildCell(
+                    Pending.Coordinates.X * 2 + (Child & 1),
+                    Pending.Coordinates.Y * 2 + ((Child >> 1) & 1),
+                    Pending.Coordinates.Z * 2 + ((Child >> 2) & 1));
+                
+                if (ChildCell.X >= ChildMin.X && ChildCell.X <= ChildMax.X &&
+                    ChildCell.Y >= ChildMin.Y && ChildCell.Y <= ChildMax.Y &&
+                    ChildCell.Z >= ChildMin.Z && ChildCell.Z <= ChildMax.Z)
+                {
+                    Stack.Add(FPendingCell{ ChildCell, ChildLevel });
+                }
+            }
+        }
+    }
+    else if (RangeCells > Cells.Num())
+    {
+        // Huge range on a flat grid: walking the occupied cells is cheaper than probing every coordinate
+        for (int32 CellIndex = 0; CellIndex < Cells.Num(); ++CellIndex)
+        {
+            const FIntVector Coordinates = GetKeyCoordinates(Cells[CellIndex].Key);
+            if (Coordinates.X >= MinCell.X && Coordinates.X <= MaxCell.X &&
+                Coordinates.Y >= MinCell.Y && Coordinates.Y <= MaxCell.Y &&
+                Coordinates.Z >= MinCell.Z && Coordinates.Z <= MaxCell.Z)
+            {
+                Visitor(CellIndex);
+            }
+        }
+    }
+    else
+    {
+        for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+        {
+            for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+            {
+                for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+                {
+                    VisitCell(FIntVector(X, Y, Z));
+                }
+            }
+        }
+    }
+}
+
+void FSpatialEntityBatch::AppendEntitiesInCellRange(const FIntVector& MinCell, const FIntVector& MaxCell, TArray<FSpatialEntityRef>& OutEntities) const
+{
+    ForEachCellInRange(MinCell, MaxCell, [&](int32 CellIndex)
+    {
+        OutEntities.Append(GetCellRefs(Cells[CellIndex]));
+    });
+}
+
+template<typename TQueryAt, typename TEmit>
+void FSpatialEntityBatch::ScanCell(const FGridCell& Cell, int32 NumQueries, TQueryAt&& QueryAt, TEmit&& Emit) const
+{
+    struct FQueryLanes
+    {
+        VectorRegister4Float X;
+        VectorRegister4Float Y;
+        VectorRegister4Float Z;
+        VectorRegister4Float RadiusSq;
+    };
+    
+    // Queries moved into the cell-relative space of the lanes, splatted across a register
+    TArray<FQueryLanes, TInlineAllocator<16>> QueryLanes;
+    QueryLanes.SetNumUninitialized(NumQueries);
+    
+    const FVector Origin = GetCellOrigin(Cell.Key);
+    for (int32 Query = 0; Query < NumQueries; ++Query)
+    {
+        const FSpatialQuery& SpatialQuery = QueryAt(Query);
+        const FVector Local = SpatialQuery.Position - Origin;
+        QueryLanes[Query].X = VectorSetFloat1(float(Local.X));
+        QueryLanes[Query].Y = VectorSetFloat1(float(Local.Y));
+        QueryLanes[Query].Z = VectorSetFloat1(float(Local.Z));
+        QueryLanes[Query].RadiusSq = VectorSetFloat1(FMath::Square(SpatialQuery.Radius));
+    }
+    
+    const float* LaneX = EntryX.GetData() + Cell.Start;
+    const float* LaneY = EntryY.GetData() + Cell.Start;
+    const float* LaneZ = EntryZ.GetData() + Cell.Start;
+    
+    // Cell ranges hold whole registers, so the last group never reads past the range
+    for (int32 Base = 0; Base < Cell.Num; Base += 4)
+    {
+        const VectorRegister4Float X = VectorLoad(LaneX + Base);
+        const VectorRegister4Float Y = VectorLoad(LaneY + Base);
+        const VectorRegister4Float Z = VectorLoad(LaneZ + Base);
+        
+        // Lanes past the end of the cell hold stale entries
+        const uint32 ValidMask = Cell.Num - Base >= 4 ? 0xF : (1u << (Cell.Num - Base)) - 1;
+        
+        for (int32 Query = 0; Query < NumQueries; ++Query)
+        {
+            const FQueryLanes& Lanes = QueryLanes[Query];
+            const VectorRegister4Float DeltaX = VectorSubtract(X, Lanes.X);
+            const VectorRegister4Float DeltaY = VectorSubtract(Y, Lanes.Y);
+            const VectorRegister4Float DeltaZ = VectorSubtract(Z, Lanes.Z);
+            
+            VectorRegister4Float DistanceSq = VectorMultiply(DeltaX, DeltaX);
+            DistanceSq = VectorMultiplyAdd(DeltaY, DeltaY, DistanceSq);
+            DistanceSq = VectorMultiplyAdd(DeltaZ, DeltaZ, DistanceSq);
+            
+            uint32 HitMask = uint32(VectorMaskBits(VectorCompareLE(DistanceSq, Lanes.RadiusSq))) & ValidMask;
+            while (HitMask)
+            {
+                Emit(Query, Cell.Start + Base + int32(FMath::CountTrailingZeros(HitMask)));
+                HitMask &= HitMask - 1;
+            }
+        }
+    }
+}
+
+TArray<FSpatialEntityRef> FSpatialEntityBatch::GetNearbyEntities(const FVector& Position, float Radius) const
+{
+    TArray<FSpatialEntityRef> NearbyEntities;
+    GetNearbyEntities(Position, Radius, NearbyEntities);
+    return NearbyEntities;
+}
+
+int32 FSpatialEntityBatch::GetNearbyEntities(const FVector& Position, float Radius, TArray<FSpatialEntityRef>& OutEntities) const
+{
+    const int32 NumBefore = OutEntities.Num();
+    const FSpatialQuery Query(Position, Radius);
+    
+    // Inclusive range of cells overlapping the query sphere's bounds
+    const FIntVector MinCell = GetCellCoordinates(Position - FVector(Radius));
+    const FIntVector MaxCell = GetCellCoordinates(Position + FVector(Radius));
+    
+    // Check the entities in each nearby grid
+    ForEachCellInRange(MinCell, MaxCell, [&](int32 CellIndex)
+    {
+        ScanCell(Cells[CellIndex], 1, [&Query](int32) -> const FSpatialQuery& { return Query; }, [&](int32, int32 PoolIndex)
+        {
+            OutEntities.Add(EntryRefs[PoolIndex]);
+        });
+    });
+    
+    return OutEntities.Num() - NumBefore;
+}
+
+void FSpatialEntityBatch::GetNearbyEntities(TArrayView<const FSpatialQuery> Queries, FSpatialQueryResults& OutResults, bool bParallel) const
+{
+    typedef FSpatialQueryResults::FCellQuery FCellQuery;
+    typedef FSpatialQueryResults::FQueryHit FQueryHit;
+    
+    OutResults.Entities.Reset();
+    OutResults.Offsets.Reset();
+    OutResults.Offsets.SetNumZeroed(Queries.Num() + 1);
+    OutResults.CellQueries.Reset();
+    OutResults.CellRuns.Reset();
+    
+    if (Queries.Num() == 0 || IsEmpty())
+    {
+        return;
+    }
+    
+    // First pass: the occupied cells each query overlaps
+    for (int32 QueryIndex = 0; QueryIndex < Queries.Num(); ++QueryIndex)
+    {
+        const FSpatialQuery& Query = Queries[QueryIndex];
+        const FIntVector MinCell = GetCellCoordinates(Query.Position - FVector(Query.Radius));
+        const FIntVector MaxCell = GetCellCoordinates(Query.Position + FVector(Query.Radius));
+        
+        ForEachCellInRange(MinCell, MaxCell, [&](int32 CellIndex)
+        {
+            OutResults.CellQueries.Add(FCellQuery{ CellIndex, QueryIndex });
+        });
+    }
+    
+    // Group by cell so every cell is scanned once for all of its queries
+    OutResults.CellQueries.Sort([](const FCellQuery& A, const FCellQuery& B)
+    {
+        return A.CellIndex != B.CellIndex ? A.CellIndex < B.CellIndex : A.QueryIndex < B.QueryIndex;
+    });
+    
+    for (int32 Index = 0; Index < OutResults.CellQueries.Num(); ++Index)
+    {
+        if (Index == 0 || OutResults.CellQueries[Index].CellIndex != OutResults.CellQueries[Index - 1].CellIndex)
+        {
+            OutResults.CellRuns.Add(Index);
+        }
+    }
+    const int32 NumRuns = OutResults.CellRuns.Num();
+    OutResults.CellRuns.Add(OutResults.CellQueries.Num());
+    
+    // Second pass: chunks of cells scanned in parallel, each collecting its own hits
+    const int32 NumChunks = FMath::DivideAndRoundUp(NumRuns, ENHANCED_TICK_QUERY_CELLS_PER_CHUNK);
+    if (OutResults.ChunkHits.Num() < NumChunks)
+    {
+        OutResults.ChunkHits.SetNum(NumChunks);
+    }
+    
+    ParallelFor(NumChunks, [this, Queries, NumRuns, &OutResults](int32 Chunk)
+    {
+        TArray<FQueryHit>& Hits = OutResults.ChunkHits[Chunk];
+        Hits.Reset();
+        
+        const int32 EndRun = FMath::Min((Chunk + 1) * ENHANCED_TICK_QUERY_CELLS_PER_CHUNK, NumRuns);
+        for (int32 Run = Chunk * ENHANCED_TICK_QUERY_CELLS_PER_CHUNK; Run < EndRun; ++Run)
+        {
+            const FCellQuery* RunQueries = OutResults.CellQueries.GetData() + OutResults.CellRuns[Run];
+            const int32 NumRunQueries = OutResults.CellRuns[Run + 1] - OutResults.CellRuns[Run];
+            
+            ScanCell(Cells[RunQueries[0].CellIndex], NumRunQueries,
+                [Queries, RunQueries](int32 Query) -> const FSpatialQuery& { return Queries[RunQueries[Query].QueryIndex]; },
+                [this, RunQueries, &Hits](int32 Query, int32 PoolIndex)
+                {
+                    Hits.Add(FQueryHit{ RunQueries[Query].QueryIndex, EntryRefs[PoolIndex] });
+                });
+        }
+    }, !bParallel || NumChunks < 2);
+    
+    // Scatter the hits into one contiguous range per query
+    TArray<int32>& Offsets = OutResults.Offsets;
+    for (int32 Chunk = 0; Chunk < NumChunks; ++Chunk)
+    {
+        for (const FQueryHit& Hit : OutResults.ChunkHits[Chunk])
+        {
+            Offsets[Hit.QueryIndex + 1]++;
+        }
+    }
+    for (int32 QueryIndex = 0; QueryIndex < Queries.Num(); ++QueryIndex)
+    {
+        Offsets[QueryIndex + 1] += Offsets[QueryIndex];
+    }
+    
+    OutResults.WriteCursors.Reset();
+    OutResults.WriteCursors.Append(Offsets);
+    OutResults.Entities.SetNumUninitialized(Offsets.Last());
+    for (int32 Chunk = 0; Chunk < NumChunks; ++Chunk)
+    {
+        for (const FQueryHit& Hit : OutResults.ChunkHits[Chunk])
+        {
+            OutResults.Entities[OutResults.WriteCursors[Hit.QueryIndex]++] = Hit.Ref;
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FSpatialNeighbourCache Implementation
+
+void FSpatialNeighbourCache::Build(const FSpatialEntityBatch& Grid, TArrayView<const FSpatialEntityBatch::FCellKey> CellKeys)
+{
+    Reset();
+    
+    for (const FSpatialEntityBatch::FCellKey CellKey : CellKeys)
+    {
+        if (Ranges.Contains(CellKey))
+        {
+            continue;
+        }
+        
+        // The cell and its 26 neighbours: every entity within one cell size of any point in the cell
+        const FIntVector Coordinates = FSpatialEntityBatch::GetKeyCoordinates(CellKey);
+        const int32 Start = Candidates.Num();
+        Grid.AppendEntitiesInCellRange(Coordinates - FIntVector(1), Coordinates + FIntVector(1), Candidates);
+        
+        Ranges.Add(CellKey, FCandidateRange{ Start, Candidates.Num() - Start });
+    }
+}
+
+void FSpatialNeighbourCache::Reset()
+{
+    // Keep the memory, the cache is rebuilt every frame
+    Ranges.Reset();
+    Candidates.Reset();
+}
+
+TArrayView<const FSpatialEntityRef> FSpatialNeighbourCache::GetCandidates(FSpatialEntityBatch::FCellKey CellKey) const
+{
+    const FCandidateRange* Range = Ranges.Find(CellKey);
+    if (!Range)
+    {
+        return TArrayView<const FSpatialEntityRef>();
+    }
+    
+    return TArrayView<const FSpatialEntityRef>(Candidates.GetData() + Range->Start, Range->Num);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FEnhancedTickDataLane Implementation
+
+FEnhancedTickDataLane::FEnhancedTickDataLane()
+    : TickGroup(TG_PrePhysics)
+    , Flags(ETickBatchFlags::UseParallel)
+    , LODFrame(nullptr)
+    , LastFrameTickCount(0)
+    , LastFrameDeferredCount(0)
+    , AverageElementTimeNs(0.0f)
+    , NumElements(0)
+{
+    // The positions the tick LOD measures from
+    AddColumn<float>();
+    AddColumn<float>();
+    AddColumn<float>();
+}
+
+int32 FEnhancedTickDataLane::AddColumnBytes(int32 ElementSize)
+{
+    check(ElementSize > 0);
+    checkf(NumElements == 0, TEXT("Columns of data lane %s must be added before its elements"), *Name.ToString());
+    
+    FColumn& Column = Columns.AddDefaulted_GetRef();
+    Column.ElementSize = ElementSize;
+    ColumnPointers.Add(nullptr);
+    return Columns.Num() - 1;
+}
+
+void FEnhancedTickDataLane::ResizeColumns(int32 NewNum)
+{
+    // Padding to whole vectors lets kernels run their last vector without a scalar tail.
+    // Columns only ever grow here, so churn of removals and additions does not reallocate.
+    const int32 PaddedNum = Align(NewNum, 4);
+    for (int32 ColumnIdx = 0; ColumnIdx < Columns.Num(); ++ColumnIdx)
+    {
+        FColumn& Column = Columns[ColumnIdx];
+        if (Column.Data.Num() < PaddedNum * Column.ElementSize)
+        {
+            Column.Data.SetNumZeroed(PaddedNum * Column.ElementSize);
+        }
+        ColumnPointers[ColumnIdx] = Column.Data.GetData();
+    }
+    
+    const int32 NumChunks = FMath::DivideAndRoundUp(NewNum, ChunkSize);
+    const int32 OldNumChunks = ChunkLastTickTimes.Num();
+    ChunkLastTickTimes.SetNum(NumChunks, false);
+    ChunkBounds.SetNum(NumChunks, false);
+    for (int32 Chunk = OldNumChunks; Chunk < NumChunks; ++Chunk)
+    {
+        ChunkLastTickTimes[Chunk] = -1.0;
+        ChunkBounds[Chunk] = FBox3f(ForceInit);
+    }
+    
+    NumElements = NewNum;
+}
+
+int32 FEnhancedTickDataLane::AddElements(int32 Count)
+{
+    check(Count >= 0);
+    
+    const int32 First = NumElements;
+    ResizeColumns(NumElements + Count);
+    
+    // Kernels may have written to the padding
+    for (FColumn& Column : Columns)
+    {
+        FMemory::Memzero(Column.Data.GetData() + SIZE_T(First) * Column.ElementSize, SIZE_T(Count) * Column.ElementSize);
+    }
+    
+    // The new elements have no bounds yet, so their chunks tick at full rate until they have
+    for (int32 Chunk = First / ChunkSize; Chunk < ChunkBounds.Num(); ++Chunk)
+    {
+        ChunkBounds[Chunk] = FBox3f(ForceInit);
+    }
+    
+    return First;
+}
+
+void FEnhancedTickDataLane::RemoveAtSwap(int32 Index)
+{
+    check(Index >= 0 && Index < NumElements);
+    
+    // The vacated last slot becomes padding and is cleared; the columns keep their memory
+    const int32 Last = NumElements - 1;
+    for (int32 ColumnIdx = 0; ColumnIdx < Columns.Num(); ++ColumnIdx)
+    {
+        const int32 ElementSize = Columns[ColumnIdx].ElementSize;
+        uint8* Data = ColumnPointers[ColumnIdx];
+        if (Index != Last)
+        {
+            FMemory::Memcpy(Data + SIZE_T(Index) * ElementSize, Data + SIZE_T(Last) * ElementSize, ElementSize);
+        }
+        FMemory::Memzero(Data + SIZE_T(Last) * ElementSize, ElementSize);
+    }
+    
+    if (Index != Last)
+    {
+        ChunkBounds[Index / ChunkSize] = FBox3f(ForceInit);
+    }
+    
+    ResizeColumns(Last);
+}
+
+void FEnhancedTickDataLane::Empty()
+{
+    for (int32 ColumnIdx = 0; ColumnIdx < Columns.Num(); ++ColumnIdx)
+    {
+        Columns[ColumnIdx].Data.Empty();
+        ColumnPointers[ColumnIdx] = nullptr;
+    }
+    
+    ChunkLastTickTimes.Empty();
+    ChunkBounds.Empty();
+    TickChunks.Empty();
+    TickDeltaTimes.Empty();
+    NumElements = 0;
+}
+
+void FEnhancedTickDataLane::SetSettings(const FEnhancedTickBatchSettings& InSettings)
+{
+    Settings = InSettings;
+    
+    // Interval lookup walks the bands from the nearest one outwards
+    Settings.LODBands.Sort([](const FEnhancedTickLODBand& A, const FEnhancedTickLODBand& B)
+    {
+        return A.MaxDistance < B.MaxDistance;
+    });
+}
+
+int32 FEnhancedTickDataLane::GetChunkLODInterval(int32 Chunk) const
+{
+    const FBox3f& Bounds = ChunkBounds[Chunk];
+    if (!Bounds.IsValid)
+    {
+        return 1;
+    }
+    
+    // The nearest point of the chunk decides, so no element ticks slower than its own distance asks for
+    float MinDistanceSq = MAX_flt;
+    for (const FVector& ViewLocation : LODFrame->ViewLocations)
+    {
+        MinDistanceSq = FMath::Min(MinDistanceSq, Bounds.ComputeSquaredDistanceToPoint(FVector3f(ViewLocation)));
+    }
+    
+    // Bands are kept sorted by distance
+    for (const FEnhancedTickLODBand& Band : Settings.LODBands)
+    {
+        if (MinDistanceSq <= FMath::Square(Band.MaxDistance))
+        {
+            return FMath::Max(1, Band.TickInterval);
+        }
+    }
+    
+    return FMath::Max(1, Settings.LODFarTickInterval);
+}
+
+void FEnhancedTickDataLane::Tick(float DeltaTime, int64 RemainingCycles)
+{
+    LastFrameTickCount = 0;
+    LastFrameDeferredCount = 0;
+    LastFrameCounters = FEnhancedTickHardwareCounters();
+    
+    if (NumElements == 0 || !Kernel)
+    {
+        return;
+    }
+    
+    TRACE_CPUPROFILER_EVENT_SCOPE_TEXT_ON_CHANNEL(*TraceName, EnhancedTickChannel);
+    
+    // Whole chunks are due or not: low priority phases and the LOD of the chunk bounds,
+    // without viewers the LOD is off. Lanes that are not owned by a system tick every chunk.
+    const int32 NumChunks = ChunkLastTickTimes.Num();
+    const int32 LowPrioInterval = EnumHasAnyFlags(Flags, ETickBatchFlags::LowPrio) ? FMath::Max(1, Settings.LowPriorityTickInterval) : 1;
+    const bool bUseLOD = LODFrame && Settings.IsTickLODEnabled() && LODFrame->ViewLocations.Num() > 0;
+    const uint64 FrameNumber = LODFrame ? LODFrame->FrameNumber : GFrameCounter;
+    
+    TickChunks.Reset(NumChunks);
+    for (int32 Chunk = 0; Chunk < NumChunks; ++Chunk)
+    {
+        const int32 Interval = bUseLOD ? FMath::Max(LowPrioInterval, GetChunkLODInterval(Chunk)) : LowPrioInterval;
+        if (Interval == 1 || ((FrameNumber + uint64(Chunk)) % Interval) == 0)
+        {
+            TickChunks.Add(Chunk);
+        }
+    }
+    
+    // Over budget: tick the due chunks that waited longest, the rest carries over. The per-element
+    // average is CPU time, so parallel lanes are estimated conservatively; one chunk always ticks while any
+    // budget is left, and HighPrio lanes as well as lanes without a measurement yet tick in full.
+    if (RemainingCycles != MAX_int64 && !EnumHasAnyFlags(Flags, ETickBatchFlags::HighPrio) && AverageElementTimeNs > 0.0f && TickChunks.Num() > 0)
+    {
+        int32 BudgetChunks = 0;
+        if (RemainingCycles > 0)
+        {
+            const double CyclesPerChunk = double(AverageElementTimeNs) * ChunkSize * 1.0e-9 / FPlatformTime::GetSecondsPerCycle64();
+            BudgetChunks = FMath::Clamp(int32(FMath::Min(double(RemainingCycles) / FMath::Max(CyclesPerChunk, 1.0), double(MAX_int32))), 1, TickChunks.Num());
+        }
+        
+        if (BudgetChunks < TickChunks.Num())
+        {
+            for (const int32 Chunk : TickChunks)
+            {
+                LastFrameDeferredCount += FMath::Min(ChunkSize, NumElements - Chunk * ChunkSize);
+            }
+            
+            KeepOldestTicks(TickChunks, BudgetChunks, [this](int32 Chunk) { return ChunkLastTickTimes[Chunk]; });
+            
+            for (const int32 Chunk : TickChunks)
+            {
+                LastFrameDeferredCount -= FMath::Min(ChunkSize, NumElements - Chunk * ChunkSize);
+            }
+            
+            TraceSchedulingDecision(EEnhancedTickTraceDecision::BudgetOverrun, TraceName, LastFrameDeferredCount, BudgetChunks * ChunkSize);
+        }
+    }
+    
+    if (TickChunks.Num() == 0)
+    {
+        return;
+    }
+    
+    // A chunk gets the true time since its last tick, however it was held back
+    const double Now = LODFrame ? LODFrame->SimulationTime : 0.0;
+    TickDeltaTimes.SetNum(TickChunks.Num());
+    for (int32 Slot = 0; Slot < TickChunks.Num(); ++Slot)
+    {
+        const int32 Chunk = TickChunks[Slot];
+        const double LastTickTime = ChunkLastTickTimes[Chunk];
+        TickDeltaTimes[Slot] = (LODFrame && LastTickTime >= 0.0) ? float(Now - LastTickTime) : DeltaTime;
+        ChunkLastTickTimes[Chunk] = Now;
+        LastFrameTickCount += FMath::Min(ChunkSize, NumElements - Chunk * ChunkSize);
+    }
+    
+    const FSpatialEntityBatch* Grid = LODFrame ? LODFrame->Grid : nullptr;
+    
+    // Chunks own disjoint element ranges, so the kernel and the bounds update need no synchronization
+    auto TickChunk = [this, Grid](int32 Slot)
+    {
+        FEnhancedTickDataChunk Data;
+        Data.First = TickChunks[Slot] * ChunkSize;
+        Data.Num = FMath::Min(ChunkSize, NumElements - Data.First);
+        Data.DeltaTime = TickDeltaTimes[Slot];
+        Data.Grid = Grid;
+        Data.ColumnData = ColumnPointers.GetData();
+        Kernel(Data);
+        
+        const float* X = Data.GetColumn<float>(PositionX);
+        const float* Y = Data.GetColumn<float>(PositionY);
+        const float* Z = Data.GetColumn<float>(PositionZ);
+        
+        FBox3f Bounds(FVector3f(X[0], Y[0], Z[0]), FVector3f(X[0], Y[0], Z[0]));
+        for (int32 i = 1; i < Data.Num; ++i)
+        {
+            Bounds.Min = FVector3f(FMath::Min(Bounds.Min.X, X[i]), FMath::Min(Bounds.Min.Y, Y[i]), FMath::Min(Bounds.Min.Z, Z[i]));
+            Bounds.Max = FVector3f(FMath::Max(Bounds.Max.X, X[i]), FMath::Max(Bounds.Max.Y, Y[i]), FMath::Max(Bounds.Max.Z, Z[i]));
+        }
+        ChunkBounds[TickChunks[Slot]] = Bounds;
+    };
+    
+    // Participants claim chunks until none remain, as in a parallel batch tick
+    std::atomic<int32> NextSlot(0);
+    std::atomic<uint64> TotalCycles(0);
+    FCriticalSection CountersLock;
+    const int32 NumSlots = TickChunks.Num();
+    
+    auto Run = [&]()
+    {
+        const uint64 StartCycles = FPlatformTime::Cycles64();
+        const FEnhancedTickHardwareCounterScope CounterScope;
+        
+        for (int32 Slot = NextSlot.fetch_add(1, std::memory_order_relaxed); Slot < NumSlots; Slot = NextSlot.fetch_add(1, std::memory_order_relaxed))
+        {
+            TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("EnhancedTick Chunk", EnhancedTickChannel);
+            TickChunk(Slot);
+        }
+        
+        TotalCycles.fetch_add(FPlatformTime::Cycles64() - StartCycles, std::memory_order_relaxed);
+        
+        if (CounterScope.bActive)
+        {
+            const FEnhancedTickHardwareCounters Counters = CounterScope.Stop();
+            FScopeLock Lock(&CountersLock);
+            LastFrameCounters += Counters;
+        }
+    };
+    
+    FGraphEventArray HelperTasks;
+    if (EnumHasAnyFlags(Flags, ETickBatchFlags::UseParallel) && NumSlots > 1)
+    {
+        // Worker slots are shared with the batches and the other worlds; the game thread works along,
+        // so the lane can do without helpers when all slots are taken
+        UEnhancedTickScheduler* Scheduler = LODFrame ? LODFrame->Scheduler : nullptr;
+        const int32 NumWorkers = Scheduler ? FMath::Min(FTaskGraphInterface::Get().GetNumWorkerThreads(), LODFrame->WorkerShare) : FTaskGraphInterface::Get().GetNumWorkerThreads();
+        
+        int32 NumHelpers = FMath::Max(0, FMath::Min(NumWorkers, NumSlots - 1));
+        if (Scheduler)
+        {
+            NumHelpers = Scheduler->AcquireWorkers(NumHelpers, 0);
+        }
+        HelperTasks.Reserve(NumHelpers);
+        
+        for (int32 HelperIdx = 0; HelperIdx < NumHelpers; ++HelperIdx)
+        {
+            HelperTasks.Add(FFunctionGraphTask::CreateAndDispatchWhenReady([&Run, Scheduler]()
+            {
+                Run();
+                
+                if (Scheduler)
+                {
+                    Scheduler->ReleaseWorkers(1);
+                }
+            }, TStatId(), nullptr, ENamedThreads::AnyThread));
+        }
+    }
+    
+    Run();
+    
+    // The helpers reference this frame, so they are always waited for
+    if (HelperTasks.Num() > 0)
+    {
+        FTaskGraphInterface::Get().WaitUntilTasksComplete(HelperTasks);
+    }
+    
+    AverageElementTimeNs = float(FPlatformTime::ToSeconds64(TotalCycles.load()) * 1.0e9) / LastFrameTickCount;
+}
+
+void FEnhancedTickDataLane::RecordFrameHistory()
+{
+    if (LastFrameTickCount > 0)
+    {
+        History.AddFrame(GetLastFrameTimeMs(), AverageElementTimeNs, LastFrameTickCount, LastFrameCounters);
+    }
+}
+
+SIZE_T FEnhancedTickDataLane::GetAllocatedSize() const
+{
+    SIZE_T Size = Columns.GetAllocatedSize() + ColumnPointers.GetAllocatedSize() + ChunkLastTickTimes.GetAllocatedSize()
+        + ChunkBounds.GetAllocatedSize() + TickChunks.GetAllocatedSize() + TickDeltaTimes.GetAllocatedSize();
+    
+    for (const FColumn& Column : Columns)
+    {
+        Size += Column.Data.GetAllocatedSize();
+    }
+    
+    return Size;
+}
+
+FEnhancedDataLaneKernel MakeDataLaneIntegrateKernel(int32 VelocityColumn)
+{
+    return [VelocityColumn](const FEnhancedTickDataChunk& Chunk)
+    {
+        float* RESTRICT X = Chunk.GetColumn<float>(FEnhancedTickDataLane::PositionX);
+        float* RESTRICT Y = Chunk.GetColumn<float>(FEnhancedTickDataLane::PositionY);
+        float* RESTRICT Z = Chunk.GetColumn<float>(FEnhancedTickDataLane::PositionZ);
+        const float* RESTRICT VX = Chunk.GetColumn<float>(VelocityColumn);
+        const float* RESTRICT VY = Chunk.GetColumn<float>(VelocityColumn + 1);
+        const float* RESTRICT VZ = Chunk.GetColumn<float>(VelocityColumn + 2);
+        
+        // Chunks start aligned and columns are padded to whole vectors, so the tail needs no scalar loop
+        const VectorRegister4Float Delta = VectorSetFloat1(Chunk.DeltaTime);
+        for (int32 i = 0; i < Chunk.Num; i += 4)
+        {
+            VectorStoreAligned(VectorMultiplyAdd(VectorLoadAligned(VX + i), Delta, VectorLoadAligned(X + i)), X + i);
+            VectorStoreAligned(VectorMultiplyAdd(VectorLoadAligned(VY + i), Delta, VectorLoadAligned(Y + i)), Y + i);
+            VectorStoreAligned(VectorMultiplyAdd(VectorLoadAligned(VZ + i), Delta, VectorLoadAligned(Z + i)), Z + i);
+        }
+    };
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FEnhancedTickGroupFunction Implementation
+
+void FEnhancedTickGroupFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+    if (System && TickType != LEVELTICK_ViewportsOnly)
+    {
+        System->ExecuteGroupTick(BatchGroup, DeltaTime);
+    }
+}
+
+FString FEnhancedTickGroupFunction::DiagnosticMessage()
+{
+    return FString::Printf(TEXT("EnhancedTickSystem[%s]"), *UEnum::GetValueAsString(BatchGroup));
+}
+
+FName FEnhancedTickGroupFunction::DiagnosticContext(bool bDetailed)
+{
+    return FName(TEXT("EnhancedTickSystem"));
+}
+
+//////////////////////////////////////////////////////////////////////////
+// UEnhancedTickSystem Implementation
+
+UEnhancedTickSystem::UEnhancedTickSystem()
+    : NextRequestSerial(0)
+    , FrameCounter(0)
+    , FrameBudgetCycles(0)
+    , FrameBudgetCyclesUsed(0)
+    , bDebugMode(false)
+    , bVerboseDebug(false)
+{
+    FMemory::Memzero(GroupBudgetCycles);
+}
+
+void UEnhancedTickSystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+    
+    UE_LOG(LogTemp, Log, TEXT("EnhancedTickSystem initialized"));
+    
+    // Initialize tick groups
+    static TArray<ETickingGroup> AllGroups = {
+        TG_PrePhysics, TG_StartPhysics, TG_DuringPhysics, TG_EndPhysics,
+        TG_PostPhysics, TG_PostUpdateWork, TG_LastDemotable
+    };
+    
+    for (ETickingGroup Group : AllGroups)
+    {
+        GroupedBatches.Add(Group, TArray<FComponentTypeBatch*>());
+        
+        // Set up the engine tick function of the group; it is registered once the world begins play
+        FEnhancedTickGroupFunction& TickFunction = GroupTickFunctions[Group];
+        TickFunction.System = this;
+        TickFunction.BatchGroup = Group;
+        TickFunction.TickGroup = Group;
+        TickFunction.EndTickGroup = Group;
+        TickFunction.bCanEverTick = true;
+        TickFunction.bStartWithTickEnabled = true;
+        TickFunction.bTickEvenWhenPaused = false;
+        TickFunction.bAllowTickOnDedicatedServer = true;
+    }
+    
+    // The pre-physics function also runs the per-frame housekeeping, so it goes first in its group
+    GroupTickFunctions[TG_PrePhysics].bHighPriority = true;
+    
+    // Set spatial grid size (e.g., 2000.0f units, which corresponds to 20 meters)
+    SpatialBatch.Configure(2000.0f, SpatialBatch.NumHierarchyLevels);
+    
+    // Share the budget and the workers with the tick systems of the other worlds in the process
+    LODFrame.Scheduler = GEngine ? GEngine->GetEngineSubsystem<UEnhancedTickScheduler>() : nullptr;
+    if (LODFrame.Scheduler)
+    {
+        LODFrame.Scheduler->RegisterSystem(this);
+        LODFrame.WorkerShare = LODFrame.Scheduler->GetWorkerShare(this);
+    }
+}
+
+void UEnhancedTickSystem::Deinitialize()
+{
+    Super::Deinitialize();
+    
+    UE_LOG(LogTemp, Log, TEXT("EnhancedTickSystem shut down"));
+    
+    // Wait for work still running on the workers
+    JoinAsyncBatches(TG_MAX);
+    
+    if (LODFrame.Scheduler)
+    {
+        LODFrame.Scheduler->UnregisterSystem(this);
+        LODFrame.Scheduler = nullptr;
+    }
+    
+    // Stop automatic registration
+    AutoRegisteredClasses.Empty();
+    UpdateAutoRegistrationHooks();
+    
+    // Remove our tick functions from the level
+    for (FEnhancedTickGroupFunction& TickFunction : GroupTickFunctions)
+    {
+        if (TickFunction.IsTickFunctionRegistered())
+        {
+            TickFunction.UnRegisterTickFunction();
+        }
+        TickFunction.System = nullptr;
+    }
+    
+    // Clear all batches; the pool releases their storage in one pass once nothing points into it
+    GroupedBatches.Empty();
+    TypeBatches.Empty();
+    BatchPool.Reset();
+    DataLanes.Empty();
+    SpatialBatch.Empty();
+    NeighbourCache.Reset();
+    RegisteredEntities.Empty();
+    NativeTickStates.Empty();
+    DeferredOperations.Empty();
+}
+
+void UEnhancedTickSystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+    
+    // The pre-physics function is always needed: it processes registrations for every group.
+    // The last one closes every frame.
+    RegisterGroupTickFunction(TG_PrePhysics);
+    RegisterGroupTickFunction(TG_LastDemotable);
+    
+    // Register the groups that were populated before play started
+    for (const auto& GroupPair : GroupedBatches)
+    {
+        if (GroupPair.Value.Num() > 0)
+        {
+            RegisterGroupTickFunction(GroupPair.Key);
+        }
+    }
+    
+    for (const auto& Pair : DataLanes)
+    {
+        RegisterGroupTickFunction(Pair.Value->TickGroup);
+    }
+    
+    // Join groups set before play started
+    for (const auto& Pair : BatchSettings)
+    {
+        RegisterJoinTickFunction(Pair.Value);
+    }
+}
+
+void UEnhancedTickSystem::RegisterGroupTickFunction(ETickingGroup Group)
+{
+    if (Group >= TG_NewlySpawned)
+    {
+        return;
+    }
+    
+    FEnhancedTickGroupFunction& TickFunction = GroupTickFunctions[Group];
+    if (TickFunction.IsTickFunctionRegistered() || !TickFunction.System)
+    {
+        return;
+    }
+    
+    UWorld* World = GetWorld();
+    if (!World || !World->HasBegunPlay() || !World->PersistentLevel)
+    {
+        // OnWorldBeginPlay picks it up later
+        return;
+    }
+    
+    TickFunction.RegisterTickFunction(World->PersistentLevel);
+    
+    if (bVerboseDebug)
+    {
+        UE_LOG(LogTemp, Log, TEXT("EnhancedTickSystem: Tick function registered for %s"), *UEnum::GetValueAsString(Group));
+    }
+}
+
+void UEnhancedTickSystem::RegisterJoinTickFunction(const FEnhancedTickBatchSettings& Settings)
+{
+    if (!Settings.bDeferredJoin)
+    {
+        return;
+    }
+    
+    // Registered before any dispatch, and ahead of the other tick functions of the group, so they see the completed batch
+    const ETickingGroup JoinGroup = FMath::Min<ETickingGroup>(Settings.JoinTickGroup, TG_LastDemotable);
+    GroupTickFunctions[JoinGroup].bHighPriority = true;
+    RegisterGroupTickFunction(JoinGroup);
+}
+
+FTickFunction* UEnhancedTickSystem::GetGroupTickFunction(ETickingGroup Group)
+{
+    return Group < TG_NewlySpawned ? &GroupTickFunctions[Group] : nullptr;
+}
+
+void UEnhancedTickSystem::ExecuteGroupTick(ETickingGroup Group, float DeltaTime)
+{
+    SCOPE_CYCLE_COUNTER(STAT_EnhancedTick_Total);
+    
+    // The first group of the frame does the housekeeping for all of them
+    if (Group == TG_PrePhysics)
+    {
+        BeginFrame(DeltaTime);
+    }
+    
+    TickGroupBatches(Group, DeltaTime);
+    
+    // The last group closes the frame, after every batch and lane of it
+    if (Group == TG_LastDemotable)
+    {
+        EndFrame(DeltaTime);
+    }
+}
+
+void UEnhancedTickSystem::BeginFrame(float DeltaTime)
+{
+    // Debug output
+    if (bDebugMode)
+    {
+        UE_LOG(LogTemp, Verbose, TEXT("EnhancedTickSystem Tick: DeltaTime=%.4f"), DeltaTime);
+        
+        if (bVerboseDebug && GEngine)
+        {
+            GEngine->AddOnScreenDebugMessage(-1, DeltaTime, FColor::Green,
+                FString::Printf(TEXT("EnhancedTickSystem: %d batches, %d entities"),
+                TypeBatches.Num(), Stats.TotalRegisteredEntities));
+        }
+    }
+    
+    // Update the frame counter (for low priority ticks)
+    // Never wraps, so phase slots (FrameCounter + Slot) % Interval stay stable
+    FrameCounter++;
+    
+    // Nothing may still be running from the previous frame when batches are modified
+    JoinAsyncBatches(TG_MAX);
+    
+    // All batches of the previous frame are accounted for
+    Stats.CompleteFrame();
+    
+    // Viewers and time for the tick LOD
+    UpdateLODFrame(DeltaTime);
+    
+    // Worlds without players get a smaller share of the global budget and the workers
+    if (LODFrame.Scheduler)
+    {
+        LODFrame.Scheduler->BeginWorldFrame(this, LODFrame.ViewLocations.Num() > 0);
+        LODFrame.WorkerShare = LODFrame.Scheduler->GetWorkerShare(this);
+    }
+    
+    // A new frame starts with the full budget
+    FrameBudgetCyclesUsed = 0;
+    
+    // Process deferred operations
+    ProcessDeferredOperations();
+    
+    // Current positions for the grid, the cache order and the tick LOD
+    RefreshEntityPositions();
+    
+    // Neighbour candidates for this frame's perception work
+    UpdateNeighbourCache();
+    
+    // First, sort the groups that need to be ticked
+    SortBatchesByPriority();
+}
+
+void UEnhancedTickSystem::RefreshEntityPositions()
+{
+    SCOPE_CYCLE_COUNTER(STAT_EnhancedTick_PositionRefresh);
+    
+    TArray<int32> Movers;
+    
+    for (auto& Pair : TypeBatches)
+    {
+        FComponentTypeBatch& Batch = *Pair.Value;
+        
+        // Batches that do not tick do not need positions either
+        if (LODFrame.bDedicatedServer && Batch.Settings.bCosmetic)
+        {
+            continue;
+        }
+        
+        Movers.Reset();
+        Batch.GatherEntityPositions(Movers);
+        
+        // Only entities that moved are touched from here on
+        const bool bSpatialAware = EnumHasAnyFlags(Batch.Flags, ETickBatchFlags::SpatialAware);
+        for (const int32 DenseIndex : Movers)
+        {
+            const FVector Position = Batch.Entities.Positions[DenseIndex];
+            
+            // New sort key; invalidates the cache order only when the sort cell changed
+            Batch.UpdateEntityPosition(DenseIndex, Position);
+            
+            uint64& CellKey = Batch.Entities.SpatialBucketIds[DenseIndex];
+            if (bSpatialAware)
+            {
+                CellKey = SpatialBatch.MoveEntity(FSpatialEntityRef(Pair.Key, Batch.Entities.GetHandle(DenseIndex)), CellKey, Position);
+            }
+            else
+            {
+                CellKey = SpatialBatch.CalculateGridCell(Position);
+            }
+        }
+    }
+}
+
+void UEnhancedTickSystem::UpdateNeighbourCache()
+{
+    SCOPE_CYCLE_COUNTER(STAT_EnhancedTick_NeighbourCache);
+    
+    NeighbourCacheCells.Reset();
+    
+    // One entry per entity; the cache builds each distinct cell once
+    for (const auto& Pair : TypeBatches)
+    {
+        const FComponentTypeBatch& Batch = *Pair.Value;
+        if (!Batch.bUsesNeighbourCache)
+        {
+            continue;
+        }
+        
+        for (const int32 DenseIndex : Batch.Entities.GetActiveIndices())
+        {
+            NeighbourCacheCells.Add(Batch.Entities.SpatialBucketIds[DenseIndex]);
+        }
+    }
+    
+    if (NeighbourCacheCells.Num() == 0)
+    {
+        NeighbourCache.Reset();
+        return;
+    }
+    
+    NeighbourCache.Build(SpatialBatch, NeighbourCacheCells);
+}
+
+TArrayView<const FSpatialEntityRef> UEnhancedTickSystem::GetNeighbourCandidates(const FVector& Position) const
+{
+    return NeighbourCache.GetCandidates(SpatialBatch.CalculateGridCell(Position));
+}
+
+void UEnhancedTickSystem::UpdateLODFrame(float DeltaTime)
+{
+    LODFrame.SimulationTime += DeltaTime;
+    LODFrame.FrameNumber = FrameCounter;
+    LODFrame.Grid = &SpatialBatch;
+    LODFrame.ViewLocations.Reset();
+    
+    UWorld* World = GetWorld();
+    if (!World)
+    {
+        return;
+    }
+    
+    const ENetMode NetMode = World->GetNetMode();
+    LODFrame.bIsServer = NetMode == NM_DedicatedServer || NetMode == NM_ListenServer;
+    LODFrame.bDedicatedServer = NetMode == NM_DedicatedServer;
+    
+    // Servers see the controllers of all connected players; their camera views are replicated from the clients
+    for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+    {
+        const APlayerController* PlayerController = It->Get();
+        if (PlayerController && (LODFrame.bIsServer || PlayerController->IsLocalController()))
+        {
+            FVector ViewLocation;
+            FRotator ViewRotation;
+            PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+            LODFrame.ViewLocations.Add(ViewLocation);
+        }
+    }
+}
+
+void UEnhancedTickSystem::EndFrame(float DeltaTime)
+{
+    // Every asynchronous batch is joined by the end of the frame; the last group is also the last join point
+    JoinAsyncBatches(TG_MAX);
+    
+    // If it's time for optimization, optimize batches
+    if (FrameCounter % 300 == 0) // Optimize every 300 frames
+    {
+        OptimizeBatches();
+    }
+}
+
+void UEnhancedTickSystem::RegisterComponent(UActorComponent* Component, ETickBatchFlags Flags, UObject* CustomTickTarget, FName CustomTickFunction)
+{
+    if (!IsValid(Component))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("EnhancedTickSystem: Invalid component cannot be registered"));
+        return;
+    }
+    
+    // THREAD SAFETY CHECK:
+    // Scene components keep UseParallel, but only tick off the game thread through a two-phase compute kernel
+    if (bVerboseDebug && EnumHasAnyFlags(Flags, ETickBatchFlags::UseParallel) &&
+        IsGameThreadOnlyClass(Component->GetClass()) && !RegisteredComputeKernels.Contains(Component->GetClass()))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("EnhancedTickSystem: %s is not thread-safe and ticks on the game thread unless a compute kernel is registered"),
+            *Component->GetName());
+    }
+    
+    // Queue the component for asynchronous registration; its standard tick is taken over when the request is carried out
+    QueueRegistration(Component, Flags, CustomTickTarget, CustomTickFunction);
+    
+    if (bVerboseDebug)
+    {
+        UE_LOG(LogTemp, Log, TEXT("EnhancedTickSystem: Component queued for registration: %s"), *Component->GetName());
+    }
+}
+
+void UEnhancedTickSystem::RegisterActor(AActor* Actor, ETickBatchFlags Flags, bool bIncludeComponents)
+{
+    if (!IsValid(Actor))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("EnhancedTickSystem: Invalid actor cannot be registered"));
+        return;
+    }
+    
+    // Queue the actor for registration; its standard tick is taken over when the request is carried out
+    QueueRegistration(Actor, Flags);
+    
+    // Also register all components of the actor if required
+    if (bIncludeComponents)
+    {
+        Actor->ForEachComponent(false, [this, Flags](UActorComponent* Component)
+        {
+            if (IsValid(Component) && Component->PrimaryComponentTick.bCanEverTick)
+            {
+                QueueRegistration(Component, Flags);
+            }
+        });
+    }
+    
+    if (bVerboseDebug)
+    {
+        UE_LOG(LogTemp, Log, TEXT("EnhancedTickSystem: Actor queued for registration: %s"), *Actor->GetName());
+    }
+}
+
+void UEnhancedTickSystem::RegisterAllComponentsOfType(TSubclassOf<UActorComponent> ComponentClass, ETickBatchFlags Flags)
+{
+    if (!ComponentClass)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("EnhancedTickSystem: Invalid component class specified"));
+        return;
+    }
+    
+    // Find all components of the specified type in the world
+    UWorld* World = GetWorld();
+    if (!World)
+    {
+        return;
+    }
+    
+    // Gather every match first, so the whole set is queued in one pass and its batches grow once
+    TArray<UActorComponent*> Components;
+    for (TActorIterator<AActor> It(World); It; ++It)
+    {
+        AActor* Actor = *It;
+        if (!IsValid(Actor))
+        {
+            continue;
+        }
+        
+        Actor->ForEachComponent(false, [&Components, ComponentClass](UActorComponent* Component)
+        {
+            if (Component->IsA(ComponentClass))
+            {
+                Components.Add(Component);
+            }
+        });
+    }
+    
+    RegisterComponents(Components, Flags);
+    
+    if (bVerboseDebug)
+    {
+        UE_LOG(LogTemp, Log, TEXT("EnhancedTickSystem: All components of type %s registered"), 
+            *ComponentClass->GetName());
+    }
+}
+
+void UEnhancedTickSystem::RegisterComponents(const TArray<UActorComponent*>& Components, ETickBatchFlags Flags)
+{
+    // Queue the components for asynchronous registration; the queue takes no lock
+    for (UActorComponent* Component : Components)
+    {
+        if (IsValid(Component) && Component->PrimaryComponentTick.bCanEverTick)
+        {
+            QueueRegistration(Component, Flags);
+        }
+    }
+    
+    if (bVerboseDebug)
+    {
+        UE_LOG(LogTemp, Log, TEXT("EnhancedTickSystem: %d components queued for registration"), Components.Num());
+    }
+}
+
+void UEnhancedTickSystem::EnableAutoRegistration(TSubclassOf<UActorComponent> ComponentClass, ETickBatchFlags Flags)
+{
+    if (!ComponentClass)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("EnhancedTickSystem: Invalid component class specified"));
+        return;
+    }
+    
+    AutoRegisteredClasses.Add(ComponentClass, Flags);
+    UpdateAutoRegistrationHooks();
+}
+
+void UEnhancedTickSystem::DisableAutoRegistration(TSubclassOf<UActorComponent> ComponentClass)
+{
+    AutoRegisteredClasses.Remove(ComponentClass);
+    UpdateAutoRegistrationHooks();
+}
+
+void UEnhancedTickSystem::UpdateAutoRegistrationHooks()
+{
+    UWorld* World = GetWorld();
+    if (!World)
+    {
+        return;
+    }
+    
+    const bool bWantHooks = AutoRegisteredClasses.Num() > 0;
+    
+    if (bWantHooks && !ActorSpawnedHandle.IsValid())
+    {
+        ActorSpawnedHandle = World->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &UEnhancedTickSystem::HandleActorSpawned));
+        LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &UEnhancedTickSystem::HandleLevelAddedToWorld);
+    }
+    else if (!bWantHooks && ActorSpawnedHandle.IsValid())
+    {
+        World->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+        FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+        ActorSpawnedHandle.Reset();
+        LevelAddedHandle.Reset();
+    }
+}
+
+void UEnhancedTickSystem::AutoRegisterActorComponents(TArrayView<AActor* const> Actors)
+{
+    // One bulk registration per flag combination
+    TArray<UActorComponent*> Components;
+    for (const auto& AutoPair : AutoRegisteredClasses)
+    {
+        UClass* ComponentClass = AutoPair.Key;
+        if (!ComponentClass)
+        {
+            continue;
+        }
+        
+        Components.Reset();
+        for (AActor* Actor : Actors)
+        {
+            if (!IsValid(Actor))
+            {
+                continue;
+            }
+            
+            Actor->ForEachComponent(false, [&Components, ComponentClass](UActorComponent* Component)
+            {
+                if (Component->IsA(ComponentClass))
+                {
+                    Components.Add(Component);
+                }
+            });
+        }
+        
+        if (Components.Num() > 0)
+        {
+            RegisterComponents(Components, AutoPair.Value);
+        }
+    }
+}
+
+void UEnhancedTickSystem::HandleActorSpawned(AActor* Actor)
+{
+    AutoRegisterActorComponents(TArrayView<AActor* const>(&Actor, 1));
+}
+
+void UEnhancedTickSystem::HandleLevelAddedToWorld(ULevel* Level, UWorld* World)
+{
+    if (Level && World == GetWorld())
+    {
+        const TArray<AActor*> LevelActors(Level->Actors);
+        AutoRegisterActorComponents(LevelActors);
+    }
+}
+
+void UEnhancedTickSystem::DisableNativeTick(UObject* Object)
+{
+    FNativeTickState State = { false, false, false };
+    
+    if (UActorComponent* Component = Cast<UActorComponent>(Object))
+    {
+        // Clearing bCanEverTick only keeps the tick function from being registered. Components taken over after
+        // BeginPlay (spawn and streaming hooks, late registrations) already have it registered with the level,
+        // so it is disabled there as well.
+        FTickFunction& TickFunction = Component->PrimaryComponentTick;
+        State.bCanEverTick = TickFunction.bCanEverTick;
+        State.bTickRegistered = TickFunction.IsTickFunctionRegistered();
+        State.bTickEnabled = TickFunction.IsTickFunctionEnabled();
+        
+        if (State.bCanEverTick && State.bTickRegistered && State.bTickEnabled)
+        {
+            Component->SetComponentTickEnabled(false);
+        }
+        TickFunction.bCanEverTick = false;
+    }
+    else if (AActor* Actor = Cast<AActor>(Object))
+    {
+        State.bTickEnabled = Actor->IsActorTickEnabled();
+        Actor->SetActorTickEnabled(false);
+    }
+    
+    NativeTickStates.Add(Object, State);
+}
+
+void UEnhancedTickSystem::RestoreNativeTick(UObject* Object)
+{
+    // Only what the take over changed is put back
+    FNativeTickState State;
+    if (!NativeTickStates.RemoveAndCopyValue(Object, State) || !IsValid(Object))
+    {
+        return;
+    }
+    
+    if (UActorComponent* Component = Cast<UActorComponent>(Object))
+    {
+        Component->PrimaryComponentTick.bCanEverTick = State.bCanEverTick;
+        
+        if (State.bTickRegistered)
+        {
+            if (State.bCanEverTick && State.bTickEnabled)
+            {
+                Component->SetComponentTickEnabled(true);
+            }
+        }
+        else if (State.bCanEverTick && Component->IsRegistered() && Component->GetOwner() && Component->GetOwner()->HasActorBegunPlay())
+        {
+            // Taken over before BeginPlay, so the level never got the tick function: register it now. The component
+            // counts its tick functions as registered already, which is why they are cycled.
+            Component->RegisterAllComponentTickFunctions(false);
+            Component->RegisterAllComponentTickFunctions(true);
+        }
+    }
+    else if (AActor* Actor = Cast<AActor>(Object))
+    {
+        if (State.bTickEnabled)
+        {
+            Actor->SetActorTickEnabled(true);
+        }
+    }
+}
+
+void UEnhancedTickSystem::UnregisterComponent(UActorComponent* Component)
+{
+    if (!IsValid(Component))
+    {
+        return;
+    }
+    
+    // Queue the component for deferred unregistration; its standard tick is given back when the request is carried out
+    QueueUnregistration(Component);
+    
+    if (bVerboseDebug)
+    {
+        UE_LOG(LogTemp, Log, TEXT("EnhancedTickSystem: Component queued for unregistration: %s"), 
+            *Component->GetName());
+    }
+}
+
+void UEnhancedTickSystem::UnregisterActor(AActor* Actor, bool bIncludeComponents)
+{
+    if (!IsValid(Actor))
+    {
+        return;
+    }
+    
+    // Queue the actor for deferred unregistration; its standard tick is given back when the request is carried out
+    QueueUnregistration(Actor);
+    
+    // Also queue all components of the actor for removal if required
+    if (bIncludeComponents)
+    {
+        Actor->ForEachComponent(false, [this](UActorComponent* Component)
+        {
+            if (IsValid(Component))
+            {
+                QueueUnregistration(Component);
+            }
+        });
+    }
+    
+    if (bVerboseDebug)
+    {
+        UE_LOG(LogTemp, Log, TEXT("EnhancedTickSystem: Actor queued for unregistration: %s"), 
+            *Actor->GetName());
+    }
+}
+
+void UEnhancedTickSystem::SetDebugMode(bool bEnable, bool bVerbose)
+{
+    bDebugMode = bEnable;
+    bVerboseDebug = bVerbose;
+    
+    UE_LOG(LogTemp, Log, TEXT("EnhancedTickSystem: Debug mode %s"), 
+        bEnable ? TEXT("enabled") : TEXT("disabled"));
+}
+
+bool UEnhancedTickSystem::SetHardwareCountersEnabled(bool bEnable)
+{
+    if (!bEnable)
+    {
+        GEnhancedTickHardwareCountersEnabled = false;
+        return false;
+    }
+    
+#if PLATFORM_LINUX
+    // Probe on the game thread; worker threads open their own groups lazily
+    if (!GEnhancedTickThreadCounters.Open())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("EnhancedTickSystem: Hardware counters unavailable (perf_event_open failed, check kernel.perf_event_paranoid)"));
+        return false;
+    }
+    
+    // Windows recorded without counters would dilute the percentiles
+    if (!GEnhancedTickHardwareCountersEnabled.exchange(true))
+    {
+        ResetBatchStats();
+    }
+    return true;
+#else
+    UE_LOG(LogTemp, Warning, TEXT("EnhancedTickSystem: Hardware counters are only supported on Linux"));
+    return false;
+#endif
+}
+
+void UEnhancedTickSystem::OptimizeBatches()
+{
+    SCOPE_CYCLE_COUNTER(STAT_EnhancedTick_Total);
+    
+    if (bVerboseDebug)
+    {
+        UE_LOG(LogTemp, Log, TEXT("EnhancedTickSystem: Batch optimization started"));
+    }
+    
+    // Flags before the passes, to trace what they changed
+    TArray<TPair<UClass*, ETickBatchFlags>> PreviousFlags;
+    const bool bTraceFlags = UE_TRACE_CHANNELEXPR_IS_ENABLED(EnhancedTickChannel);
+    if (bTraceFlags)
+    {
+        PreviousFlags.Reserve(TypeBatches.Num());
+        for (const auto& Pair : TypeBatches)
+        {
+            PreviousFlags.Emplace(Pair.Key, Pair.Value->Flags);
+        }
+    }
+    
+    // Analyze the current state for profiling data
+    AnalyzeCurrentState();
+    
+    // Apply optimization hints
+    ApplyOptimizationHints();
+    
+    // Optimize for specific component types
+    for (auto& Pair : TypeBatches)
+    {
+        UClass* Class = Pair.Key;
+        FComponentTypeBatch& Batch = *Pair.Value;
+        
+        // Special optimization for CharacterMovementComponent
+        if (Class->IsChildOf(UCharacterMovementComponent::StaticClass()))
+        {
+            OptimizeCharacterMovementBatch(Batch);
+            UE_LOG(LogTemp, Log, TEXT("EnhancedTickSystem: Batch optimization UCharacterMovementComponent"));
+        }
+        // Special optimization for AIPerceptionComponent
+        else if (Class->IsChildOf(UAIPerceptionComponent::StaticClass()))
+        {
+            OptimizeAIPerceptionBatch(Batch);
+            UE_LOG(LogTemp, Log, TEXT("EnhancedTickSystem: Batch optimization UAIPerceptionComponent"));
+        }
+    }
+    
+    for (const TPair<UClass*, ETickBatchFlags>& Previous : PreviousFlags)
+    {
+        const FComponentTypeBatch* Batch = TypeBatches.FindRef(Previous.Key);
+        if (Batch && Batch->Flags != Previous.Value)
+        {
+            TraceSchedulingDecision(EEnhancedTickTraceDecision::FlagChange, Batch->TypeName, int32(Previous.Value), int32(Batch->Flags));
+        }
+    }
+    
+    if (bVerboseDebug)
+    {
+        UE_LOG(LogTemp, Log, TEXT("EnhancedTickSystem: Batch optimization completed"));
+    }
+}
+
+TArray<FEnhancedTickBatchStats> UEnhancedTickSystem::GetBatchStats() const
+{
+    TArray<FEnhancedTickBatchStats> BatchStats;
+    BatchStats.Reserve(TypeBatches.Num());
+    
+    for (const auto& Pair : TypeBatches)
+    {
+        const FComponentTypeBatch& Batch = *Pair.Value;
+        if (Batch.History.NumSamples == 0)
+        {
+            continue;
+        }
+        
+        FEnhancedTickBatchStats& Entry = BatchStats.AddDefaulted_GetRef();
+        Entry.BatchClass = Pair.Key;
+        Batch.History.GetStats(FrameCounter, Entry);
+    }
+    
+    BatchStats.Sort([](const FEnhancedTickBatchStats& A, const FEnhancedTickBatchStats& B)
+    {
+        return A.BatchTimeMs.P95 > B.BatchTimeMs.P95;
+    });
+    
+    return BatchStats;
+}
+
+bool UEnhancedTickSystem::GetBatchStatsForClass(TSubclassOf<UObject> Class, FEnhancedTickBatchStats& OutStats) const
+{
+    const FComponentTypeBatch* Batch = TypeBatches.FindRef(Class.Get());
+    if (!Batch)
+    {
+        return false;
+    }
+    
+    OutStats.BatchClass = Class.Get();
+    Batch->History.GetStats(FrameCounter, OutStats);
+    return true;
+}
+
+int64 UEnhancedTickSystem::GetMemoryReport(TArray<FEnhancedTickBatchMemory>& OutBatches) const
+{
+    OutBatches.Reset(TypeBatches.Num());
+    
+    int64 TotalBytes = 0;
+    for (const auto& Pair : TypeBatches)
+    {
+        FEnhancedTickBatchMemory& Entry = OutBatches.AddDefaulted_GetRef();
+        Pair.Value->GetMemoryFootprint(Entry);
+        TotalBytes += Entry.TotalBytes;
+    }
+    
+    OutBatches.Sort([](const FEnhancedTickBatchMemory& A, const FEnhancedTickBatchMemory& B)
+    {
+        return A.TotalBytes > B.TotalBytes;
+    });
+    
+    // Unused slots of the last pool chunk, the shared grid and the bookkeeping of the system
+    TotalBytes += int64(BatchPool.GetAllocatedSize()) - int64(BatchPool.Num()) * int64(sizeof(FComponentTypeBatch));
+    TotalBytes += TypeBatches.GetAllocatedSize() + SpatialBatch.GetAllocatedSize() + NeighbourCache.GetAllocatedSize()
+        + NeighbourCacheCells.GetAllocatedSize() + RegisteredEntities.GetAllocatedSize() + DataLanes.GetAllocatedSize();
+    
+    // Data lanes are not batches of a class, so they only count towards the total
+    for (const auto& Pair : DataLanes)
+    {
+        TotalBytes += sizeof(FEnhancedTickDataLane) + Pair.Value->GetAllocatedSize();
+    }
+    
+    return TotalBytes;
+}
+
+void UEnhancedTickSystem::ResetBatchStats()
+{
+    for (auto& Pair : TypeBatches)
+    {
+        Pair.Value->History.Reset();
+    }
+    
+    for (auto& Pair : DataLanes)
+    {
+        Pair.Value->History.Reset();
+    }
+}
+
+TMap<FString, float> UEnhancedTickSystem::GetBatchProfilingData() const
+{
+    TMap<FString, float> ProfilingData;
+    
+    for (const auto& Pair : TypeBatches)
+    {
+        UClass* Class = Pair.Key;
+        const FComponentTypeBatch& Batch = *Pair.Value;
+        
+        if (Class)
+        {
+            ProfilingData.Add(Class->GetName(), Batch.AverageTickTimeNs);
+        }
+    }
+    
+    return ProfilingData;
+}
+
+FString UEnhancedTickSystem::GetDetailedStats() const
+{
+    FString StatsString;
+    
+    StatsString += FString::Printf(TEXT("Total Registered Entities: %d\n"), Stats.TotalRegisteredEntities);
+    StatsString += FString::Printf(TEXT("Active Entities: %d\n"), Stats.ActiveEntities);
+    StatsString += FString::Printf(TEXT("Parallel Batch Count: %d\n"), Stats.ParallelBatchCount);
+    StatsString += FString::Printf(TEXT("Spatial Batch Count: %d\n"), Stats.SpatialBatchCount);
+    StatsString += FString::Printf(TEXT("Total Tick Time: %.4f ms\n"), Stats.TotalTickTimeMs);
+    StatsString += FString::Printf(TEXT("Cache Miss Count: %llu\n"), Stats.CacheMissCount);
+    StatsString += FString::Printf(TEXT("Budget Deferred Entities: %d\n"), Stats.BudgetDeferredEntities);
+    StatsString += FString::Printf(TEXT("Cosmetic Skipped Entities: %d\n"), Stats.CosmeticSkippedEntities);
+    
+    TArray<FEnhancedTickBatchMemory> BatchMemory;
+    const int64 MemoryBytes = GetMemoryReport(BatchMemory);
+    StatsString += FString::Printf(TEXT("Memory: %.2f MB (spatial grid %.2f MB)\n"), MemoryBytes / (1024.0 * 1024.0), SpatialBatch.GetAllocatedSize() / (1024.0 * 1024.0));
+    
+    // Rolling windows of the most expensive batches
+    const TArray<FEnhancedTickBatchStats> BatchStats = GetBatchStats();
+    const int32 NumListed = FMath::Min(BatchStats.Num(), ENHANCED_TICK_DETAILED_STATS_BATCHES);
+    
+    for (int32 Index = 0; Index < NumListed; ++Index)
+    {
+        const FEnhancedTickBatchStats& Entry = BatchStats[Index];
+        
+        StatsString += FString::Printf(TEXT("\n%s (%d frames)\n"), *GetNameSafe(Entry.BatchClass), Entry.NumFrames);
+        StatsString += FString::Printf(TEXT("  Batch Time ms: p50 %.3f p95 %.3f p99 %.3f max %.3f\n"),
+            Entry.BatchTimeMs.P50, Entry.BatchTimeMs.P95, Entry.BatchTimeMs.P99, Entry.BatchTimeMs.Max);
+        StatsString += FString::Printf(TEXT("  Entity Cost ns: p50 %.0f p95 %.0f p99 %.0f max %.0f\n"),
+            Entry.EntityCostNs.P50, Entry.EntityCostNs.P95, Entry.EntityCostNs.P99, Entry.EntityCostNs.Max);
+        StatsString += FString::Printf(TEXT("  Entities: p50 %.0f p95 %.0f max %.0f\n"),
+            Entry.EntityCount.P50, Entry.EntityCount.P95, Entry.EntityCount.Max);
+        
+        if (GEnhancedTickHardwareCountersEnabled)
+        {
+            StatsString += FString::Printf(TEXT("  Cache Misses/Entity: p50 %.2f p95 %.2f max %.2f, IPC p50 %.2f\n"),
+                Entry.CacheMissesPerEntity.P50, Entry.CacheMissesPerEntity.P95, Entry.CacheMissesPerEntity.Max, Entry.InstructionsPerCycle.P50);
+        }
+        
+        for (const FEnhancedTickEntityOutlier& Outlier : Entry.Outliers)
+        {
+            StatsString += FString::Printf(TEXT("  Outlier: %s %.1f us (%d frames ago)\n"),
+                *GetNameSafe(Outlier.Object), Outlier.CostUs, Outlier.FramesAgo);
+        }
+    }
+    
+    return StatsString;
+}
+
+void UEnhancedTickSystem::AnalyzeCurrentState()
+{
+    // Counted from the current state, not accumulated across analyses
+    Stats.ParallelBatchCount = 0;
+    
+    // Analyze profiling data for each batch. Serial vs parallel and the cache sort are chosen by measurement
+    // in FComponentTypeBatch::UpdateAdaptiveMode; only the priority is decided here.
+    FEnhancedTickBatchStats WindowStats;
+    for (auto& Pair : TypeBatches)
+    {
+        FComponentTypeBatch& Batch = *Pair.Value;
+        
+        if (Batch.CanTickInParallel())
+        {
+            Stats.ParallelBatchCount++;
+        }
+        
+        // Priorities given at registration are pins, and a half-empty window is not enough evidence
+        if (EnumHasAnyFlags(Batch.Flags, ETickBatchFlags::HighPrio) || EnumHasAnyFlags(Batch.UserFlags, ETickBatchFlags::LowPrio) ||
+            Batch.History.NumSamples < FEnhancedTickBatchHistory::NumFrames / 2)
+        {
+            continue;
+        }
+        
+        // Demote consistently cheap batches, promote them back once they are clearly not cheap any more
+        Batch.History.GetStats(FrameCounter, WindowStats);
+        const bool bLowPrio = EnumHasAnyFlags(Batch.Flags, ETickBatchFlags::LowPrio);
+        if (!bLowPrio && WindowStats.EntityCostNs.P95 < ENHANCED_TICK_LOWPRIO_DEMOTE_NS)
+        {
+            Batch.Flags |= ETickBatchFlags::LowPrio;
+        }
+        else if (bLowPrio && WindowStats.EntityCostNs.P50 > ENHANCED_TICK_LOWPRIO_PROMOTE_NS)
+        {
+            Batch.Flags &= ~ETickBatchFlags::LowPrio;
+        }
+    }
+}
+
+void UEnhancedTickSystem::ApplyOptimizationHints()
+{
+    // Identify spatially aware components
+    for (auto& Pair : TypeBatches)
+    {
+        UClass* Class = Pair.Key;
+        FComponentTypeBatch& Batch = *Pair.Value;
+        
+        if (!IsValid(Class))
+        {
+            continue;
+        }
+        
+        // Components that require location information
+        const bool bIsSpatialComponent = 
+            Class->IsChildOf(UPrimitiveComponent::StaticClass()) ||
+            Class->IsChildOf(UAIPerceptionComponent::StaticClass()) ||
+            Class->GetName().Contains(TEXT("Spatial")) ||
+            Class->GetName().Contains(TEXT("Physics"));
+        
+        if (bIsSpatialComponent && !EnumHasAnyFlags(Batch.Flags, ETickBatchFlags::SpatialAware))
+        {
+            EnableSpatialAwareness(Batch);
+        }
+    }
+}
+
+// Grounded, server-side NPC with nothing to move it: its TickComponent would only redo the idle floor checks
+static bool IsCharacterMovementIdle(const UCharacterMovementComponent& CMC)
+{
+    const ACharacter* Character = CMC.GetCharacterOwner();
+    if (!Character || Character->GetLocalRole() != ROLE_Authority || Character->IsPlayerControlled())
+    {
+        return false;
+    }
+    
+    if (CMC.MovementMode != MOVE_Walking && CMC.MovementMode != MOVE_NavWalking)
+    {
+        return false;
+    }
+    
+    // No velocity, acceleration or input left to integrate
+    if (!CMC.Velocity.IsNearlyZero() || !CMC.GetCurrentAcceleration().IsNearlyZero() || !Character->GetPendingMovementInputVector().IsNearlyZero())
+    {
+        return false;
+    }
+    
+    // Root motion, crouch changes and moving bases drive the character without any of the above
+    if (CMC.HasRootMotionSources() || Character->IsPlayingRootMotion() || CMC.bWantsToCrouch != Character->bIsCrouched)
+    {
+        return false;
+    }
+    
+    if (MovementBaseUtility::IsDynamicBase(Character->GetMovementBase()))
+    {
+        return false;
+    }
+    
+    // A move request only turns into velocity inside the next tick
+    if (const AAIController* AIController = Cast<AAIController>(Character->GetController()))
+    {
+        if (AIController->GetMoveStatus() != EPathFollowingStatus::Idle)
+        {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+// Idle filter of character movement batches, applied before the tick times are taken. The keep-alive ticks use the
+// phase slots of the LOD frame, so idle crowds spread them across frames the same way in every world.
+static FEnhancedBatchSkipFunction MakeCharacterMovementSkipFunction()
+{
+    return [](const FTickEntityStore& Store, int32 DenseIndex, uint64 FrameNumber)
+    {
+        // Destroyed entities are left to the kernel; entities with their own tick function are never skipped
+        const UCharacterMovementComponent* CMC = static_cast<const UCharacterMovementComponent*>(Store.Objects[DenseIndex]);
+        if (!IsValid(CMC) || Store.FindCustomTickFunction(DenseIndex))
+        {
+            return false;
+        }
+        
+        const bool bKeepAlive = (FrameNumber + Store.DenseToSlot[DenseIndex]) % ENHANCED_TICK_IDLE_CHARACTER_INTERVAL == 0;
+        return !bKeepAlive && IsCharacterMovementIdle(*CMC);
+    };
+}
+
+// Character movement loop: the characters tick grouped by movement mode so each mode's code path and data
+// stay warm in the caches. Idle characters were already left out by the batch's skip function.
+static FEnhancedBatchTickFunction MakeCharacterMovementKernel()
+{
+    return [](const FTickEntityStore& Store, TArrayView<const int32> Indices, float DeltaTime)
+    {
+        // Buckets reused across calls; custom modes share the last one
+        static thread_local TArray<int32> ModeBuckets[MOVE_MAX];
+        for (TArray<int32>& Bucket : ModeBuckets)
+        {
+            Bucket.Reset();
+        }
+        
+        UObject* const* Objects = Store.Objects.GetData();
+        for (const int32 DenseIndex : Indices)
         {
-            for (int32 dz = -GridRadius; dz <= GridRadius; ++dz)
+            const UCharacterMovementComponent* CMC = static_cast<const UCharacterMovementComponent*>(Objects[DenseIndex]);
+            if (!IsValid(CMC))
             {
-                const int32 NbX = CenterX + dx;
-                const int32 NbY = CenterY + dy;
-                const int32 NbZ = CenterZ + dz;
-                
-                // Check grid boundaries
-                if (NbX < 0 || NbX > 0x3F || NbY < 0 || NbY > 0x3F || NbZ < 0 || NbZ > 0xF)
+                continue;
+            }
+            
+            ModeBuckets[FMath::Min<int32>(CMC->MovementMode, MOVE_Custom)].Add(DenseIndex);
+        }
+        
+        for (const TArray<int32>& Bucket : ModeBuckets)
+        {
+            for (int32 i = 0; i < Bucket.Num(); ++i)
+            {
+                if (i + 1 < Bucket.Num())
                 {
-                    continue;
+                    ENHANCED_TICK_PREFETCH_DATA(Objects[Bucket[i + 1]]);
                 }
                 
-                // Calculate the neighboring grid ID
-                const uint16 NbGridId = (uint16)(
-                    ((NbX & 0x3F) << 10) |
-                    ((NbY & 0x3F) << 4) |
-                    (NbZ & 0xF)
-                );
-                
-                if (NbGridId != CenterGridId)
+                // Earlier ticks may have destroyed it
+                UCharacterMovementComponent* CMC = static_cast<UCharacterMovementComponent*>(Objects[Bucket[i]]);
+                if (IsValid(CMC))
                 {
-                    NearbyGrids.Add(NbGridId);
+                    CMC->TickComponent(Store.GetDeltaTime(Bucket[i], DeltaTime), ELevelTick::LEVELTICK_All, nullptr);
                 }
             }
         }
+    };
+}
+
+FEnhancedBatchTickFunction UEnhancedTickSystem::DetermineBestTickFunction(UClass* Class)
+{
+    // Kernels registered for this exact class take precedence
+    if (const FEnhancedBatchTickFunction* RegisteredKernel = RegisteredBatchKernels.Find(Class))
+    {
+        return *RegisteredKernel;
     }
     
-    // Check the entities in each nearby grid
-    for (uint16 GridId : NearbyGrids)
+    // A batch only ever holds one class, so the loops below static_cast instead of casting per element
+    
+    // Special handling for CharacterMovementComponent - disable parallel processing as it is not thread-safe
+    if (Class->IsChildOf(UCharacterMovementComponent::StaticClass()))
     {
-        if (TArray<FTickEntityData*>* GridEntities = GridCells.Find(GridId))
+        // NO PARALLEL PROCESSING - sequential tick for thread safety, bucketed by movement mode
+        return MakeCharacterMovementKernel();
+    }
+    
+    // Actors
+    if (Class->IsChildOf(AActor::StaticClass()))
+    {
+        return MakeEnhancedBatchKernel<AActor>([](AActor& Actor, float DeltaTime)
+        {
+            Actor.Tick(DeltaTime);
+        });
+    }
+    
+    // Default tick function for general components
+    return MakeEnhancedBatchKernel<UActorComponent>([](UActorComponent& Component, float DeltaTime)
+    {
+        if (Component.IsActive())
+        {
+            Component.TickComponent(DeltaTime, ELevelTick::LEVELTICK_All, nullptr);
+        }
+    });
+}
+
+FEnhancedBatchTickFunction UEnhancedTickSystem::MakePerEntityTickFunction(UClass* Class)
+{
+    // Entities without a custom function still go through the regular kernel
+    return [DefaultKernel = DetermineBestTickFunction(Class)](const FTickEntityStore& Store, TArrayView<const int32> Indices, float DeltaTime)
+    {
+        for (int32 i = 0; i < Indices.Num(); ++i)
         {
-            for (FTickEntityData* Entity : *GridEntities)
+            const int32 DenseIndex = Indices[i];
+            
+            if (const TFunction<void(float)>* CustomTick = Store.FindCustomTickFunction(DenseIndex))
             {
-                // Check the distance
-                if (Entity && Entity->bEnabled && Entity->Object)
+                if (IsValid(Store.Objects[DenseIndex]))
                 {
-                    const float Distance = FVector::Distance(Position, Entity->Position);
-                    if (Distance <= Radius)
-                    {
-                        NearbyEntities.Add(Entity);
-                    }
+                    (*CustomTick)(Store.GetDeltaTime(DenseIndex, DeltaTime));
                 }
             }
+            else
+            {
+                DefaultKernel(Store, Indices.Slice(i, 1), DeltaTime);
+            }
         }
+    };
+}
+
+TFunction<void(float)> UEnhancedTickSystem::MakeCustomTickFunction(UObject* Target, FName FunctionName)
+{
+    UFunction* Function = IsValid(Target) ? Target->FindFunction(FunctionName) : nullptr;
+    if (!Function)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("EnhancedTickSystem: Custom tick function %s not found"), *FunctionName.ToString());
+        return TFunction<void(float)>();
     }
     
-    return NearbyEntities;
+    // Either a parameterless function or one that takes the delta time as a single float
+    const bool bTakesDeltaTime = Function->NumParms == 1 && CastField<FFloatProperty>(Function->PropertyLink) != nullptr;
+    if (Function->NumParms != 0 && !bTakesDeltaTime)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("EnhancedTickSystem: Custom tick function %s must take no parameters or a single float"),
+            *FunctionName.ToString());
+        return TFunction<void(float)>();
+    }
+    
+    TWeakObjectPtr<UObject> WeakTarget(Target);
+    return [WeakTarget, Function, bTakesDeltaTime](float DeltaTime)
+    {
+        if (UObject* TargetObject = WeakTarget.Get())
+        {
+            float Params = DeltaTime;
+            TargetObject->ProcessEvent(Function, bTakesDeltaTime ? &Params : nullptr);
+        }
+    };
 }
 
-//////////////////////////////////////////////////////////////////////////
-// UEnhancedTickSystem Implementation
-
-UEnhancedTickSystem::UEnhancedTickSystem()
-    : BatchesLock(MakeShared<FCriticalSection>())
-    , FrameCounter(0)
-    , bDebugMode(false)
-    , bVerboseDebug(false)
+void UEnhancedTickSystem::RegisterBatchTickFunction(UClass* Class, FEnhancedBatchTickFunction&& TickFunction)
 {
+    if (!IsValid(Class) || !TickFunction)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("EnhancedTickSystem: Invalid batch kernel registration"));
+        return;
+    }
+    
+    // Apply to an existing batch unless it already relies on per-entity functions
+    if (FComponentTypeBatch* Batch = TypeBatches.FindRef(Class))
+    {
+        // The kernel may still be running on the workers
+        WaitForBatch(Class);
+        
+        if (!Batch->bCustomTickFunction || RegisteredBatchKernels.Contains(Class))
+        {
+            // A user kernel sees every due entity
+            Batch->BatchTickFunction = TickFunction;
+            Batch->SkipFunction = nullptr;
+            Batch->bCustomTickFunction = true;
+        }
+    }
     
+    RegisteredBatchKernels.Add(Class, MoveTemp(TickFunction));
+    
+    if (bVerboseDebug)
+    {
+        UE_LOG(LogTemp, Log, TEXT("EnhancedTickSystem: Batch kernel registered for %s"), *Class->GetName());
+    }
 }
 
-void UEnhancedTickSystem::Initialize(FSubsystemCollectionBase& Collection)
+void UEnhancedTickSystem::RegisterBatchComputeFunction(UClass* Class, FEnhancedBatchComputeFunction&& ComputeFunction)
 {
-    Super::Initialize(Collection);
+    if (!IsValid(Class) || !ComputeFunction)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("EnhancedTickSystem: Invalid compute kernel registration"));
+        return;
+    }
     
-    UE_LOG(LogTemp, Log, TEXT("EnhancedTickSystem initialized"));
+    if (FComponentTypeBatch* Batch = TypeBatches.FindRef(Class))
+    {
+        // The previous kernel may still be running on the workers
+        WaitForBatch(Class);
+        Batch->BatchComputeFunction = ComputeFunction;
+    }
     
-    // Initialize tick groups
-    static TArray<ETickingGroup> AllGroups = {
-        TG_PrePhysics, TG_StartPhysics, TG_DuringPhysics, TG_EndPhysics,
-        TG_PostPhysics, TG_PostUpdateWork, TG_LastDemotable
-    };
+    RegisteredComputeKernels.Add(Class, MoveTemp(ComputeFunction));
     
-    for (ETickingGroup Group : AllGroups)
+    if (bVerboseDebug)
     {
-        GroupedBatches.Add(Group, TArray<FComponentTypeBatch*>());
+        UE_LOG(LogTemp, Log, TEXT("EnhancedTickSystem: Compute kernel registered for %s"), *Class->GetName());
+    }
+}
+
+bool UEnhancedTickSystem::IsGameThreadOnlyClass(UClass* Class)
+{
+    if (const bool* bCached = GameThreadOnlyClasses.Find(Class))
+    {
+        return *bCached;
     }
     
-    // Set spatial grid size (e.g., 2000.0f units, which corresponds to 20 meters)
-    SpatialBatch.GridCellSize = 2000.0f;
+    // Components (UPrimitiveComponent, USceneComponent, UCharacterMovementComponent)
+    // that may include transform updates and are not thread-safe.
+    const bool bGameThreadOnly = Class && (Class->IsChildOf<USceneComponent>() || Class->IsChildOf<UCharacterMovementComponent>());
+    GameThreadOnlyClasses.Add(Class, bGameThreadOnly);
+    return bGameThreadOnly;
 }
 
-void UEnhancedTickSystem::Deinitialize()
+FEnhancedTickDataLane& UEnhancedTickSystem::AddDataLane(FName Name, FEnhancedDataLaneKernel&& Kernel, ETickingGroup TickGroup)
 {
-    Super::Deinitialize();
+    check(IsInGameThread());
     
-    UE_LOG(LogTemp, Log, TEXT("EnhancedTickSystem shut down"));
+    TUniquePtr<FEnhancedTickDataLane>& Lane = DataLanes.FindOrAdd(Name);
+    if (!Lane.IsValid())
+    {
+        Lane = MakeUnique<FEnhancedTickDataLane>();
+        Lane->Name = Name;
+        Lane->TraceName = Name.ToString();
+        Lane->LODFrame = &LODFrame;
+    }
+    else
+    {
+        UE_LOG(LogTemp, Warning, TEXT("EnhancedTickSystem: Data lane %s already exists, replacing its kernel"), *Name.ToString());
+    }
     
-    // Clear all batches
-    TypeBatches.Empty();
-    GroupedBatches.Empty();
+    Lane->Kernel = MoveTemp(Kernel);
+    Lane->TickGroup = FMath::Min<ETickingGroup>(TickGroup, TG_LastDemotable);
+    RegisterGroupTickFunction(Lane->TickGroup);
+    
+    return *Lane;
 }
 
-void UEnhancedTickSystem::Tick(float DeltaTime)
+FEnhancedTickDataLane* UEnhancedTickSystem::FindDataLane(FName Name)
 {
-    SCOPE_CYCLE_COUNTER(STAT_EnhancedTick_Total);
+    const TUniquePtr<FEnhancedTickDataLane>* Lane = DataLanes.Find(Name);
+    return Lane ? Lane->Get() : nullptr;
+}
+
+void UEnhancedTickSystem::RemoveDataLane(FName Name)
+{
+    check(IsInGameThread());
+    DataLanes.Remove(Name);
+}
+
+bool UEnhancedTickSystem::GetDataLaneStats(FName Name, FEnhancedTickBatchStats& OutStats) const
+{
+    const TUniquePtr<FEnhancedTickDataLane>* Lane = DataLanes.Find(Name);
+    if (!Lane)
+    {
+        return false;
+    }
     
-    // Debug output
-    if (bDebugMode)
+    OutStats.BatchClass = nullptr;
+    (*Lane)->History.GetStats(FrameCounter, OutStats);
+    return true;
+}
+
+void UEnhancedTickSystem::TickGroupBatches(ETickingGroup Group, float DeltaTime)
+{
+    SCOPE_CYCLE_COUNTER(STAT_EnhancedTick_TypeBatches);
+    
+    // Everything the game thread spends on batches in this group counts against the budgets
+    uint64 GroupCyclesUsed = 0;
+    auto ChargeBudget = [this, &GroupCyclesUsed](uint64 StartCycles)
     {
-        UE_LOG(LogTemp, Verbose, TEXT("EnhancedTickSystem Tick: DeltaTime=%.4f"), DeltaTime);
+        const uint64 Cycles = FPlatformTime::Cycles64() - StartCycles;
+        GroupCyclesUsed += Cycles;
+        FrameBudgetCyclesUsed += Cycles;
         
-        if (bVerboseDebug && GEngine)
+        if (LODFrame.Scheduler)
+        {
+            LODFrame.Scheduler->ChargeCycles(this, Cycles);
+        }
+    };
+    
+    // Asynchronous batches that must be complete before this group are joined first
+    const uint64 JoinStartCycles = FPlatformTime::Cycles64();
+    JoinAsyncBatches(Group);
+    ChargeBudget(JoinStartCycles);
+    
+    if (TArray<FComponentTypeBatch*>* Batches = GroupedBatches.Find(Group))
+    {
+        // Consecutive batches with declared dependencies, ticked together as one graph
+        TArray<FComponentTypeBatch*, TInlineAllocator<16>> GraphNodes;
+        
+        // Estimated cycles of the graph nodes queued so far, reserved before they run
+        int64 GraphReservedCycles = 0;
+        
+        for (FComponentTypeBatch* Batch : *Batches)
+        {
+            if (!Batch)
+            {
+                continue;
+            }
+            
+            // Nobody renders on a dedicated server
+            if (LODFrame.bDedicatedServer && Batch->Settings.bCosmetic)
+            {
+                Stats.FrameCosmeticSkippedEntities += Batch->Entities.NumActive();
+                continue;
+            }
+            
+            // HighPrio batches are exempt from the budget
+            const int64 RemainingCycles = GetRemainingBudgetCycles(Group, GroupCyclesUsed) - GraphReservedCycles;
+            Batch->TickBudgetEntities = EnumHasAnyFlags(Batch->Flags, ETickBatchFlags::HighPrio) ? INDEX_NONE : EstimateBudgetEntities(*Batch, RemainingCycles);
+            
+            if (Batch->Settings.HasDeclaredDependencies() && !Batch->Settings.bDeferredJoin && Batch->CanTickOffGameThread())
+            {
+                if (Batch->TickBudgetEntities != INDEX_NONE && Batch->AverageTickTimeNs > 0.0f)
+                {
+                    GraphReservedCycles += int64(Batch->TickBudgetEntities * Batch->AverageTickTimeNs * 1.0e-9 / FPlatformTime::GetSecondsPerCycle64());
+                }
+                GraphNodes.Add(Batch);
+                continue;
+            }
+            
+            const uint64 StartCycles = FPlatformTime::Cycles64();
+            
+            // A batch without declared dependencies is a barrier: everything before it has to finish first
+            if (GraphNodes.Num() > 0)
+            {
+                TickBatchGraph(GraphNodes, DeltaTime);
+                GraphNodes.Reset();
+                GraphReservedCycles = 0;
+            }
+            
+            TRACE_CPUPROFILER_EVENT_SCOPE_TEXT_ON_CHANNEL(*Batch->TypeName, EnhancedTickChannel);
+            
+            // Deferred-join batches are dispatched now and joined in a later group
+            if (Batch->Settings.bDeferredJoin && Batch->Settings.JoinTickGroup > Group && Batch->CanTickInParallel())
+            {
+                if (Batch->TickBatchAsync(DeltaTime))
+                {
+                    InFlightAsyncBatches.Add(Batch);
+                    ChargeBudget(StartCycles);
+                    continue;
+                }
+            }
+            // Choose the appropriate ticking method based on parallel capability and entity count
+            else if (Batch->CanTickInParallel() && Batch->Entities.Num() > 10)
+            {
+                // Parallel tick
+                Batch->TickBatchParallel(DeltaTime);
+            }
+            else
+            {
+                if (Batch->CanTickInParallel())
+                {
+                    TraceSchedulingDecision(EEnhancedTickTraceDecision::SerialFallback, Batch->TypeName, int32(EEnhancedTickSerialFallback::TooFewEntities), Batch->Entities.NumActive());
+                }
+                
+                // Standard sequential tick
+                Batch->TickBatch(DeltaTime);
+            }
+            
+            ChargeBudget(StartCycles);
+            
+            // Update profiling data for the batch
+            UpdateBatchProfilingData(*Batch);
+            
+            // Only batches ticked right here are sampled: their wall time is not shared with other batches
+            float GainPercent = 0.0f;
+            if (Batch->UpdateAdaptiveMode(GainPercent))
+            {
+                const FEnhancedTickBatchMode& Mode = Batch->Adaptive.Candidates[Batch->Adaptive.Incumbent];
+                TraceSchedulingDecision(EEnhancedTickTraceDecision::ModeChange, Batch->TypeName, Mode.Encode(), FMath::RoundToInt(GainPercent));
+                
+                if (bVerboseDebug)
+                {
+                    UE_LOG(LogTemp, Log, TEXT("EnhancedTickSystem: %s switched to %s%s, grain x%.1f (%.0f%% faster)"), *Batch->TypeName,
+                        Mode.bParallel ? TEXT("parallel") : TEXT("serial"), Mode.bSorted ? TEXT(" sorted") : TEXT(""), Mode.GrainScale, GainPercent);
+                }
+            }
+        }
+        
+        if (GraphNodes.Num() > 0)
+        {
+            const uint64 StartCycles = FPlatformTime::Cycles64();
+            TickBatchGraph(GraphNodes, DeltaTime);
+            ChargeBudget(StartCycles);
+        }
+    }
+    
+    // Data lanes of the group tick after its batches, under the same budgets
+    for (auto& Pair : DataLanes)
+    {
+        FEnhancedTickDataLane& Lane = *Pair.Value;
+        if (Lane.TickGroup != Group)
+        {
+            continue;
+        }
+        
+        if (LODFrame.bDedicatedServer && Lane.GetSettings().bCosmetic)
         {
-            GEngine->AddOnScreenDebugMessage(-1, DeltaTime, FColor::Green,
-                FString::Printf(TEXT("EnhancedTickSystem: %d batches, %d entities"),
-                TypeBatches.Num(), Stats.TotalRegisteredEntities));
+            Stats.FrameCosmeticSkippedEntities += Lane.Num();
+            continue;
         }
+        
+        const uint64 StartCycles = FPlatformTime::Cycles64();
+        Lane.Tick(DeltaTime, EnumHasAnyFlags(Lane.Flags, ETickBatchFlags::HighPrio) ? MAX_int64 : GetRemainingBudgetCycles(Group, GroupCyclesUsed));
+        ChargeBudget(StartCycles);
+        
+        Stats.FrameTickTimeMs += Lane.GetLastFrameTimeMs();
+        Stats.FrameActiveEntities += Lane.LastFrameTickCount;
+        Stats.FrameBudgetDeferredEntities += Lane.LastFrameDeferredCount;
+        Stats.FrameCacheMissCount += Lane.LastFrameCounters.CacheMisses;
+        Lane.RecordFrameHistory();
     }
+}
+
+int64 UEnhancedTickSystem::GetRemainingBudgetCycles(ETickingGroup Group, uint64 GroupCyclesUsed) const
+{
+    int64 Remaining = MAX_int64;
     
-    // Update the frame counter (for low priority ticks)
-    FrameCounter = (FrameCounter + 1) % 1000; // Cycle every 1000 frames
-    
-    // Process deferred operations
-    ProcessDeferredOperations();
-    
-    // Update conditional tick objects
-    UpdateConditionalTicks();
+    if (FrameBudgetCycles > 0)
+    {
+        Remaining = FMath::Min(Remaining, int64(FrameBudgetCycles) - int64(FrameBudgetCyclesUsed));
+    }
     
-    // First, sort the groups that need to be ticked
-    SortBatchesByPriority();
+    if (Group < TG_NewlySpawned && GroupBudgetCycles[Group] > 0)
+    {
+        Remaining = FMath::Min(Remaining, int64(GroupBudgetCycles[Group]) - int64(GroupCyclesUsed));
+    }
     
-    // Process tick groups in order
-    TArray<ETickingGroup> TickOrder = {
-        TG_PrePhysics, TG_StartPhysics, TG_DuringPhysics, TG_EndPhysics,
-        TG_PostPhysics, TG_PostUpdateWork, TG_LastDemotable
-    };
+    // This world's share of the process-wide budget
+    if (LODFrame.Scheduler)
+    {
+        Remaining = FMath::Min(Remaining, LODFrame.Scheduler->GetRemainingCycles(this));
+    }
     
-    for (ETickingGroup Group : TickOrder)
+    return Remaining;
+}
+
+int32 UEnhancedTickSystem::EstimateBudgetEntities(const FComponentTypeBatch& Batch, int64 RemainingCycles)
+{
+    if (RemainingCycles == MAX_int64)
     {
-        TickGroupBatches(Group, DeltaTime);
+        return INDEX_NONE;
     }
     
-    // Tick spatially aware entities - include error checks
-    if (!SpatialBatch.GridCells.IsEmpty() && SpatialBatch.SpatialLock.IsValid())
+    if (RemainingCycles <= 0)
     {
-        SpatialBatch.TickAllGrids(DeltaTime);
+        return 0;
     }
     
-    // If it's time for optimization, optimize batches
-    if (FrameCounter % 300 == 0) // Optimize every 300 frames
+    // Without a measurement yet, the batch ticks in full once to get one
+    if (Batch.AverageTickTimeNs <= 0.0f)
     {
-        OptimizeBatches();
+        return INDEX_NONE;
     }
+    
+    // The per-entity average is CPU time, so parallel batches are estimated conservatively.
+    // At least one entity is ticked while any budget is left, so every batch keeps making progress.
+    const double CyclesPerEntity = Batch.AverageTickTimeNs * 1.0e-9 / FPlatformTime::GetSecondsPerCycle64();
+    const double Entities = double(RemainingCycles) / FMath::Max(CyclesPerEntity, 1.0);
+    return FMath::Max(1, int32(FMath::Min(Entities, double(MAX_int32))));
 }
 
-TStatId UEnhancedTickSystem::GetStatId() const
+void UEnhancedTickSystem::ConfigureSpatialGrid(float CellSize, int32 HierarchyLevels)
 {
-    RETURN_QUICK_DECLARE_CYCLE_STAT(UEnhancedTickSystem, STATGROUP_EnhancedTick);
+    SpatialBatch.Configure(CellSize, HierarchyLevels);
 }
 
-void UEnhancedTickSystem::RegisterComponent(UActorComponent* Component, ETickBatchFlags Flags, UObject* CustomTickTarget, FName CustomTickFunction)
+void UEnhancedTickSystem::SetFrameBudget(float Milliseconds)
 {
-    if (!IsValid(Component))
+    FrameBudgetCycles = Milliseconds > 0.0f ? uint64(Milliseconds * 0.001 / FPlatformTime::GetSecondsPerCycle64()) : 0;
+}
+
+void UEnhancedTickSystem::SetTickGroupBudget(TEnumAsByte<ETickingGroup> Group, float Milliseconds)
+{
+    if (Group >= TG_NewlySpawned)
     {
-        UE_LOG(LogTemp, Warning, TEXT("EnhancedTickSystem: Invalid component cannot be registered"));
+        UE_LOG(LogTemp, Warning, TEXT("EnhancedTickSystem: Invalid tick group for budget"));
         return;
     }
     
-    // THREAD SAFETY CHECK:
-    // For USceneComponent and its derivatives, disable parallel processing if needed
-    if ((Component->IsA<USceneComponent>() || Component->IsA<UPrimitiveComponent>() || 
-        Component->IsA<UCharacterMovementComponent>()) && 
-        EnumHasAnyFlags(Flags, ETickBatchFlags::UseParallel))
+    GroupBudgetCycles[Group] = Milliseconds > 0.0f ? uint64(Milliseconds * 0.001 / FPlatformTime::GetSecondsPerCycle64()) : 0;
+}
+
+// Whether two batches touch the same data with at least one of them writing it
+static bool DoBatchesConflict(const FEnhancedTickBatchSettings& A, const FEnhancedTickBatchSettings& B)
+{
+    for (const FName& Tag : A.Writes)
     {
-        // Remove the parallel processing flag
-        Flags &= ~ETickBatchFlags::UseParallel;
-        
-        if (bVerboseDebug)
+        if (B.Writes.Contains(Tag) || B.Reads.Contains(Tag))
         {
-            UE_LOG(LogTemp, Warning, TEXT("EnhancedTickSystem: Parallel processing disabled for %s - not thread-safe"),
-                *Component->GetName());
+            return true;
         }
     }
     
-    // Queue the component for asynchronous registration
-    if (BatchesLock.Get())
+    for (const FName& Tag : B.Writes)
     {
-        FScopeLock Lock(BatchesLock.Get());
-        PendingRegistrations.Add(TPair<UObject*, ETickBatchFlags>(Component, Flags));
-    }
-    else
-    {
-        PendingRegistrations.Add(TPair<UObject*, ETickBatchFlags>(Component, Flags));
+        if (A.Reads.Contains(Tag))
+        {
+            return true;
+        }
     }
     
-    // Disable the component's standard tick
-    Component->PrimaryComponentTick.bCanEverTick = false;
-    
-    if (bVerboseDebug)
-    {
-        UE_LOG(LogTemp, Log, TEXT("EnhancedTickSystem: Component queued for registration: %s"), *Component->GetName());
-    }
+    return false;
 }
 
-void UEnhancedTickSystem::RegisterActor(AActor* Actor, ETickBatchFlags Flags, bool bIncludeComponents)
+void UEnhancedTickSystem::TickBatchGraph(TArrayView<FComponentTypeBatch* const> Nodes, float DeltaTime)
 {
-    if (!IsValid(Actor))
+    const int32 NumNodes = Nodes.Num();
+    
+    if (NumNodes == 1)
     {
-        UE_LOG(LogTemp, Warning, TEXT("EnhancedTickSystem: Invalid actor cannot be registered"));
+        TRACE_CPUPROFILER_EVENT_SCOPE_TEXT_ON_CHANNEL(*Nodes[0]->TypeName, EnhancedTickChannel);
+        Nodes[0]->TickBatchParallel(DeltaTime);
+        UpdateBatchProfilingData(*Nodes[0]);
         return;
     }
     
-    // Queue the actor for registration
-    if (BatchesLock.Get())
+    // Explicit TickAfter edges between the nodes
+    TArray<TArray<int32, TInlineAllocator<4>>, TInlineAllocator<16>> Successors;
+    TArray<int32, TInlineAllocator<16>> InDegree;
+    Successors.SetNum(NumNodes);
+    InDegree.SetNumZeroed(NumNodes);
+    
+    for (int32 After = 0; After < NumNodes; ++After)
     {
-        FScopeLock Lock(BatchesLock.Get());
-        PendingRegistrations.Add(TPair<UObject*, ETickBatchFlags>(Actor, Flags));
-        
-        // Also register all components of the actor if required
-        if (bIncludeComponents)
+        for (const TSubclassOf<UObject>& BeforeClass : Nodes[After]->Settings.TickAfter)
         {
-            TArray<UActorComponent*> Components;
-            Actor->GetComponents(Components);
-            
-            for (UActorComponent* Component : Components)
+            for (int32 Before = 0; Before < NumNodes; ++Before)
             {
-                if (IsValid(Component) && Component->PrimaryComponentTick.bCanEverTick)
+                if (Before != After && Nodes[Before]->BatchClass == BeforeClass)
                 {
-                    PendingRegistrations.Add(TPair<UObject*, ETickBatchFlags>(Component, Flags));
-                    Component->PrimaryComponentTick.bCanEverTick = false;
+                    Successors[Before].Add(After);
+                    ++InDegree[After];
                 }
             }
         }
     }
-    else
+    
+    // Topological order of the explicit edges; among ready nodes the priority order is kept
+    TArray<int32, TInlineAllocator<16>> Order;
+    TBitArray<> Scheduled(false, NumNodes);
+    while (Order.Num() < NumNodes)
     {
-        PendingRegistrations.Add(TPair<UObject*, ETickBatchFlags>(Actor, Flags));
-        
-        // Also register all components of the actor if required
-        if (bIncludeComponents)
+        int32 Next = INDEX_NONE;
+        for (int32 Node = 0; Node < NumNodes; ++Node)
         {
-            TArray<UActorComponent*> Components;
-            Actor->GetComponents(Components);
-            
-            for (UActorComponent* Component : Components)
+            if (!Scheduled[Node] && InDegree[Node] == 0)
             {
-                if (IsValid(Component) && Component->PrimaryComponentTick.bCanEverTick)
-                {
-                    PendingRegistrations.Add(TPair<UObject*, ETickBatchFlags>(Component, Flags));
-                    Component->PrimaryComponentTick.bCanEverTick = false;
-                }
+                Next = Node;
+                break;
             }
         }
+        
+        if (Next == INDEX_NONE)
+        {
+            break;
+        }
+        
+        Scheduled[Next] = true;
+        Order.Add(Next);
+        for (const int32 Successor : Successors[Next])
+        {
+            --InDegree[Successor];
+        }
     }
     
-    // Disable the actor's standard tick
-    Actor->SetActorTickEnabled(false);
-    
-    if (bVerboseDebug)
-    {
-        UE_LOG(LogTemp, Log, TEXT("EnhancedTickSystem: Actor queued for registration: %s"), *Actor->GetName());
-    }
-}
-
-void UEnhancedTickSystem::RegisterAllComponentsOfType(TSubclassOf<UActorComponent> ComponentClass, ETickBatchFlags Flags)
-{
-    if (!ComponentClass)
+    // Dependency cycle - tick in priority order rather than guessing which edge to drop
+    if (Order.Num() < NumNodes)
     {
-        UE_LOG(LogTemp, Warning, TEXT("EnhancedTickSystem: Invalid component class specified"));
+        UE_LOG(LogTemp, Warning, TEXT("EnhancedTickSystem: Cyclic batch dependencies, ticking %d batches sequentially"), NumNodes);
+        for (FComponentTypeBatch* Batch : Nodes)
+        {
+            TRACE_CPUPROFILER_EVENT_SCOPE_TEXT_ON_CHANNEL(*Batch->TypeName, EnhancedTickChannel);
+            Batch->TickBatchParallel(DeltaTime);
+            UpdateBatchProfilingData(*Batch);
+        }
         return;
     }
     
-    // Find all components of the specified type in the world
-    UWorld* World = GetWorld();
-    if (!World)
-    {
-        return;
-    }
+    // Dispatch in topological order: each node waits for the earlier nodes it has an edge or a data conflict with
+    TArray<FGraphEventRef, TInlineAllocator<16>> NodeEvents;
+    NodeEvents.SetNum(NumNodes);
+    FGraphEventArray AllEvents;
     
-    // Iterate through all actors in the world
-    for (TActorIterator<AActor> It(World); It; ++It)
+    for (int32 Position = 0; Position < NumNodes; ++Position)
     {
-        AActor* Actor = *It;
-        if (!IsValid(Actor))
-        {
-            continue;
-        }
-        
-        // Get the actor's components of the specified type
-        TArray<UActorComponent*> Components;
-        Actor->GetComponents(ComponentClass, Components);
+        const int32 Node = Order[Position];
+        FComponentTypeBatch* Batch = Nodes[Node];
         
-        for (UActorComponent* Component : Components)
+        FGraphEventArray Prerequisites;
+        for (int32 EarlierPosition = 0; EarlierPosition < Position; ++EarlierPosition)
         {
-            if (IsValid(Component) && Component->PrimaryComponentTick.bCanEverTick)
+            const int32 Earlier = Order[EarlierPosition];
+            if (Successors[Earlier].Contains(Node) || DoBatchesConflict(Nodes[Earlier]->Settings, Batch->Settings))
             {
-                RegisterComponent(Component, Flags);
+                Prerequisites.Add(NodeEvents[Earlier]);
             }
         }
+        
+        NodeEvents[Node] = FFunctionGraphTask::CreateAndDispatchWhenReady([Batch, DeltaTime]()
+        {
+            TRACE_CPUPROFILER_EVENT_SCOPE_TEXT_ON_CHANNEL(*Batch->TypeName, EnhancedTickChannel);
+            Batch->TickBatchParallel(DeltaTime);
+        }, TStatId(), &Prerequisites, ENamedThreads::AnyThread);
+        AllEvents.Add(NodeEvents[Node]);
     }
     
-    if (bVerboseDebug)
+    FTaskGraphInterface::Get().WaitUntilTasksComplete(AllEvents, ENamedThreads::GameThread);
+    
+    for (FComponentTypeBatch* Batch : Nodes)
     {
-        UE_LOG(LogTemp, Log, TEXT("EnhancedTickSystem: All components of type %s registered"), 
-            *ComponentClass->GetName());
+        // Update profiling data for the batch
+        UpdateBatchProfilingData(*Batch);
     }
 }
 
-void UEnhancedTickSystem::UnregisterComponent(UActorComponent* Component)
+void UEnhancedTickSystem::AddBatchDependency(TSubclassOf<UObject> Before, TSubclassOf<UObject> After)
 {
-    if (!IsValid(Component))
+    if (!Before || !After || Before == After)
     {
+        UE_LOG(LogTemp, Warning, TEXT("EnhancedTickSystem: Invalid batch dependency"));
         return;
     }
     
-    // Queue the component for deferred unregistration
-    if (BatchesLock.Get())
-    {
-        FScopeLock Lock(BatchesLock.Get());
-        PendingUnregistrations.Add(Component);
-    }
-    else
-    {
-        PendingUnregistrations.Add(Component);
-    }
-    
-    // Re-enable the component's standard tick
-    Component->PrimaryComponentTick.bCanEverTick = true;
-    
-    if (bVerboseDebug)
-    {
-        UE_LOG(LogTemp, Log, TEXT("EnhancedTickSystem: Component queued for unregistration: %s"), 
-            *Component->GetName());
-    }
+    FEnhancedTickBatchSettings Settings = GetBatchSettings(After);
+    Settings.TickAfter.AddUnique(Before);
+    SetBatchSettings(After, Settings);
 }
 
-void UEnhancedTickSystem::UnregisterActor(AActor* Actor, bool bIncludeComponents)
+void UEnhancedTickSystem::JoinAsyncBatches(ETickingGroup Group)
 {
-    if (!IsValid(Actor))
-    {
-        return;
-    }
-    
-    // Queue the actor for deferred unregistration
-    if (BatchesLock.Get())
+    for (int32 Index = 0; Index < InFlightAsyncBatches.Num(); )
     {
-        FScopeLock Lock(BatchesLock.Get());
-        PendingUnregistrations.Add(Actor);
-        
-        // Also queue all components of the actor for removal if required
-        if (bIncludeComponents)
+        FComponentTypeBatch* Batch = InFlightAsyncBatches[Index];
+        if (Batch->Settings.JoinTickGroup <= Group)
         {
-            TArray<UActorComponent*> Components;
-            Actor->GetComponents(Components);
-            
-            for (UActorComponent* Component : Components)
-            {
-                if (IsValid(Component))
-                {
-                    PendingUnregistrations.Add(Component);
-                    Component->PrimaryComponentTick.bCanEverTick = true;
-                }
-            }
+            InFlightAsyncBatches.RemoveAt(Index, 1, false);
+            CompleteAsyncBatch(*Batch);
         }
-    }
-    else
-    {
-        PendingUnregistrations.Add(Actor);
-        
-        // Also queue all components of the actor for removal if required
-        if (bIncludeComponents)
+        else
         {
-            TArray<UActorComponent*> Components;
-            Actor->GetComponents(Components);
-            
-            for (UActorComponent* Component : Components)
-            {
-                if (IsValid(Component))
-                {
-                    PendingUnregistrations.Add(Component);
-                    Component->PrimaryComponentTick.bCanEverTick = true;
-                }
-            }
+            ++Index;
         }
     }
-    
-    // Re-enable the actor's standard tick
-    Actor->SetActorTickEnabled(true);
-    
-    if (bVerboseDebug)
-    {
-        UE_LOG(LogTemp, Log, TEXT("EnhancedTickSystem: Actor queued for unregistration: %s"), 
-            *Actor->GetName());
-    }
 }
 
-void UEnhancedTickSystem::SetDebugMode(bool bEnable, bool bVerbose)
+void UEnhancedTickSystem::CompleteAsyncBatch(FComponentTypeBatch& Batch)
 {
-    bDebugMode = bEnable;
-    bVerboseDebug = bVerbose;
+    if (!Batch.IsAsyncTickPending())
+    {
+        return;
+    }
     
-    UE_LOG(LogTemp, Log, TEXT("EnhancedTickSystem: Debug mode %s"), 
-        bEnable ? TEXT("enabled") : TEXT("disabled"));
+    // The join shows up under the batch name, separate from the dispatch
+    TRACE_CPUPROFILER_EVENT_SCOPE_TEXT_ON_CHANNEL(*Batch.TypeName, EnhancedTickChannel);
+    Batch.WaitForAsyncTick();
+    
+    // Update profiling data for the batch
+    UpdateBatchProfilingData(Batch);
+    
+    OnBatchCompleted.Broadcast(Batch.BatchClass);
 }
 
-void UEnhancedTickSystem::OptimizeBatches()
+void UEnhancedTickSystem::SetBatchSettings(TSubclassOf<UObject> Class, const FEnhancedTickBatchSettings& Settings)
 {
-    SCOPE_CYCLE_COUNTER(STAT_EnhancedTick_Total);
-    
-    if (bVerboseDebug)
+    if (!Class)
     {
-        UE_LOG(LogTemp, Log, TEXT("EnhancedTickSystem: Batch optimization started"));
+        UE_LOG(LogTemp, Warning, TEXT("EnhancedTickSystem: Invalid class for batch settings"));
+        return;
     }
     
-    // Analyze the current state for profiling data
-    AnalyzeCurrentState();
+    // Never change the schedule of a batch that is still running
+    WaitForBatch(Class);
     
-    // Apply optimization hints
-    ApplyOptimizationHints();
+    FEnhancedTickBatchSettings& StoredSettings = BatchSettings.Add(Class, Settings);
     
-    // Optimize for specific component types
-    for (auto& Pair : TypeBatches)
+    // Interval lookup walks the bands from the nearest one outwards
+    StoredSettings.LODBands.Sort([](const FEnhancedTickLODBand& A, const FEnhancedTickLODBand& B)
     {
-        UClass* Class = Pair.Key;
-        FComponentTypeBatch& Batch = Pair.Value;
-        
-        // Special optimization for CharacterMovementComponent
-        if (Class->IsChildOf(UCharacterMovementComponent::StaticClass()))
-        {
-            OptimizeCharacterMovementBatch(Batch);
-            UE_LOG(LogTemp, Log, TEXT("EnhancedTickSystem: Batch optimization UCharacterMovementComponent"));
-        }
-        // Special optimization for AIPerceptionComponent
-        else if (Class->IsChildOf(UAIPerceptionComponent::StaticClass()))
-        {
-            OptimizeAIPerceptionBatch(Batch);
-            UE_LOG(LogTemp, Log, TEXT("EnhancedTickSystem: Batch optimization UAIPerceptionComponent"));
-        }
-    }
+        return A.MaxDistance < B.MaxDistance;
+    });
     
-    if (bVerboseDebug)
+    if (FComponentTypeBatch* Batch = TypeBatches.FindRef(Class))
     {
-        UE_LOG(LogTemp, Log, TEXT("EnhancedTickSystem: Batch optimization completed"));
+        Batch->ApplySettings(StoredSettings);
     }
+    
+    RegisterJoinTickFunction(StoredSettings);
 }
 
-TMap<FString, float> UEnhancedTickSystem::GetBatchProfilingData() const
+FEnhancedTickBatchSettings UEnhancedTickSystem::GetBatchSettings(TSubclassOf<UObject> Class) const
 {
-    TMap<FString, float> ProfilingData;
-    
-    for (const auto& Pair : TypeBatches)
-    {
-        UClass* Class = Pair.Key;
-        const FComponentTypeBatch& Batch = Pair.Value;
-        
-        if (Class)
-        {
-            ProfilingData.Add(Class->GetName(), Batch.AverageTickTimeNs);
-        }
-    }
-    
-    return ProfilingData;
+    const FEnhancedTickBatchSettings* Settings = BatchSettings.Find(Class);
+    return Settings ? *Settings : FEnhancedTickBatchSettings();
 }
 
-FString UEnhancedTickSystem::GetDetailedStats() const
+bool UEnhancedTickSystem::IsBatchTickComplete(TSubclassOf<UObject> Class) const
 {
-    FString StatsString;
-    
-    StatsString += FString::Printf(TEXT("Total Registered Entities: %d\n"), Stats.TotalRegisteredEntities);
-    StatsString += FString::Printf(TEXT("Active Entities: %d\n"), Stats.ActiveEntities);
-    StatsString += FString::Printf(TEXT("Parallel Batch Count: %d\n"), Stats.ParallelBatchCount);
-    StatsString += FString::Printf(TEXT("Spatial Batch Count: %d\n"), Stats.SpatialBatchCount);
-    StatsString += FString::Printf(TEXT("Total Tick Time: %.4f ms\n"), Stats.TotalTickTimeMs);
-    StatsString += FString::Printf(TEXT("Cache Miss Count: %d\n"), Stats.CacheMissCount);
-    
-    return StatsString;
+    const FComponentTypeBatch* Batch = TypeBatches.FindRef(Class);
+    return !Batch || !Batch->IsAsyncTickPending() || Batch->AsyncCompletionEvent->IsComplete();
 }
 
-void UEnhancedTickSystem::AnalyzeCurrentState()
+FGraphEventRef UEnhancedTickSystem::GetBatchCompletionEvent(UClass* Class) const
 {
-    // Analyze profiling data for each batch
-    for (auto& Pair : TypeBatches)
-    {
-        UClass* Class = Pair.Key;
-        FComponentTypeBatch& Batch = Pair.Value;
-        
-        // Evaluate the potential for parallel processing based on the batch tick time
-        if (Batch.AverageTickTimeNs > 1000.0f && Batch.TickEntities.Num() > 10)
-        {
-            Batch.Flags |= ETickBatchFlags::UseParallel;
-            Stats.ParallelBatchCount++;
-        }
-        
-        // Disable cache optimization for batches with very few entities
-        if (Batch.TickEntities.Num() < 5)
-        {
-            Batch.bSortByCacheLocality = false;
-        }
-        
-        // Mark batches as low priority if tick time is very low and not high priority
-        if (Batch.AverageTickTimeNs < 100.0f && !EnumHasAnyFlags(Batch.Flags, ETickBatchFlags::HighPrio))
-        {
-            Batch.Flags |= ETickBatchFlags::LowPrio;
-        }
-    }
+    const FComponentTypeBatch* Batch = TypeBatches.FindRef(Class);
+    return Batch ? Batch->AsyncCompletionEvent : FGraphEventRef();
 }
 
-void UEnhancedTickSystem::ApplyOptimizationHints()
+void UEnhancedTickSystem::WaitForBatch(TSubclassOf<UObject> Class)
 {
-    // Identify spatially aware components
-    for (auto& Pair : TypeBatches)
+    FComponentTypeBatch* Batch = TypeBatches.FindRef(Class);
+    if (Batch && Batch->IsAsyncTickPending())
     {
-        UClass* Class = Pair.Key;
-        FComponentTypeBatch& Batch = Pair.Value;
-        
-        if (!IsValid(Class))
-        {
-            continue;
-        }
-        
-        // Components that require location information
-        const bool bIsSpatialComponent = 
-            Class->IsChildOf(UPrimitiveComponent::StaticClass()) ||
-            Class->IsChildOf(UAIPerceptionComponent::StaticClass()) ||
-            Class->GetName().Contains(TEXT("Spatial")) ||
-            Class->GetName().Contains(TEXT("Physics"));
-        
-        if (bIsSpatialComponent && !EnumHasAnyFlags(Batch.Flags, ETickBatchFlags::SpatialAware))
-        {
-            Batch.Flags |= ETickBatchFlags::SpatialAware;
-            Stats.SpatialBatchCount++;
-            
-            // Move spatially aware entities to the spatial batch
-            for (auto& Entity : Batch.TickEntities)
-            {
-                if (Entity.bEnabled && IsValid(Entity.Object))
-                {
-                    // Add a NULL check for safety
-                    if (SpatialBatch.SpatialLock.IsValid())
-                    {
-                        SpatialBatch.AddEntity(&Entity);
-                    }
-                }
-            }
-        }
+        InFlightAsyncBatches.Remove(Batch);
+        CompleteAsyncBatch(*Batch);
     }
 }
 
-TFunction<void(const TArrayView<FTickEntityData>&, float)> UEnhancedTickSystem::DetermineBestTickFunction(UClass* Class)
+void UEnhancedTickSystem::ProcessDeferredOperations()
 {
-    // Special handling for CharacterMovementComponent - disable parallel processing as it is not thread-safe
-    if (Class->IsChildOf(UCharacterMovementComponent::StaticClass()))
+    // Single consumer: drain everything queued since the last frame, in queue order
+    FDeferredOperation Operation;
+    while (DeferredOperations.Dequeue(Operation))
     {
-        return [](const TArrayView<FTickEntityData>& Entities, float DeltaTime)
+        switch (Operation.Type)
         {
-            // Prefetch the first component if available
-            if (Entities.Num() > 0 && Entities[0].Object)
-            {
-                ENHANCED_TICK_PREFETCH_DATA(Entities[0].Object);
-            }
-            
-            // NO PARALLEL PROCESSING - standard sequential tick for thread safety
-            for (int32 i = 0; i < Entities.Num(); ++i)
-            {
-                const FTickEntityData& Entity = Entities[i];
-                UCharacterMovementComponent* CMC = Cast<UCharacterMovementComponent>(Entity.Object);
-                
-                if (!CMC || !Entity.bEnabled)
-                {
-                    continue;
-                }
-                
-                // Prefetch the next component if available
-                if (i + 1 < Entities.Num() && Entities[i + 1].Object)
-                {
-                    ENHANCED_TICK_PREFETCH_DATA(Entities[i + 1].Object);
-                }
-                
-                // Tick the component (sequential processing)
-                CMC->TickComponent(DeltaTime, ELevelTick::LEVELTICK_All, nullptr);
-            }
-        };
+        case FDeferredOperation::EType::Register:
+            PendingRegistrations.Emplace(NextRequestSerial++, Operation.Object, Operation.Flags,
+                Operation.CustomTickTarget, Operation.CustomTickFunction);
+            break;
+        case FDeferredOperation::EType::Unregister:
+            PendingUnregistrations.Emplace(NextRequestSerial++, Operation.Object, Operation.bEnabled);
+            break;
+        case FDeferredOperation::EType::SetEnabled:
+            PendingEnableChanges.Emplace(Operation.Object, Operation.bEnabled);
+            break;
+        }
     }
     
-    // Default tick function for general components
-    return [](const TArrayView<FTickEntityData>& Entities, float DeltaTime)
+    if (PendingRegistrations.Num() > 0 || PendingUnregistrations.Num() > 0 || PendingEnableChanges.Num() > 0)
     {
-        // Prefetch the first component if available
-        if (Entities.Num() > 0 && Entities[0].Object)
-        {
-            ENHANCED_TICK_PREFETCH_DATA(Entities[0].Object);
-        }
-        
-        // Tick each component sequentially
-        for (int32 i = 0; i < Entities.Num(); ++i)
-        {
-            const FTickEntityData& Entity = Entities[i];
-            
-            // Prefetch the next component if available
-            if (i + 1 < Entities.Num() && Entities[i + 1].Object)
-            {
-                ENHANCED_TICK_PREFETCH_DATA(Entities[i + 1].Object);
-            }
-            
-            // Use the custom tick function if provided, otherwise call the default tick
-            if (Entity.TickFunction)
-            {
-                Entity.TickFunction(DeltaTime);
-            }
-            else if (UActorComponent* Component = Cast<UActorComponent>(Entity.Object))
-            {
-                Component->TickComponent(DeltaTime, ELevelTick::LEVELTICK_All, nullptr);
-            }
-            else if (AActor* Actor = Cast<AActor>(Entity.Object))
-            {
-                Actor->Tick(DeltaTime);
-            }
-        }
-    };
+        ProcessDeferredOperationsImpl();
+    }
 }
 
-void UEnhancedTickSystem::TickGroupBatches(ETickingGroup Group, float DeltaTime)
+// Squared distance within which players can see an actor, MAX_flt if relevancy does not depend on distance.
+// Read once at registration; actors that change their cull distance later keep the old one.
+static float GetNetRelevancyDistanceSquared(const AActor* Actor)
 {
-    SCOPE_CYCLE_COUNTER(STAT_EnhancedTick_TypeBatches);
-    
-    if (TArray<FComponentTypeBatch*>* Batches = GroupedBatches.Find(Group))
+    if (!Actor || Actor->bAlwaysRelevant || Actor->bOnlyRelevantToOwner || Actor->bNetUseOwnerRelevancy)
     {
-        for (FComponentTypeBatch* Batch : *Batches)
-        {
-            if (!Batch)
-            {
-                continue;
-            }
-            
-            // For low priority batches, skip ticking every frame based on the frame counter
-            if (EnumHasAnyFlags(Batch->Flags, ETickBatchFlags::LowPrio))
-            {
-                if ((FrameCounter % 3) != 0)
-                {
-                    continue;
-                }
-            }
-            
-            // Choose the appropriate ticking method based on parallel capability and entity count
-            if (Batch->CanTickInParallel() && Batch->TickEntities.Num() > 10)
-            {
-                // Parallel tick
-                Batch->TickBatchParallel(DeltaTime);
-            }
-            else
-            {
-                // Standard sequential tick
-                Batch->TickBatch(DeltaTime);
-            }
-            
-            // Update profiling data for the batch (convert ns to ms)
-            UpdateBatchProfilingData(*Batch, Batch->AverageTickTimeNs / 1000000.0f);
-        }
+        return MAX_flt;
     }
+    return Actor->NetCullDistanceSquared;
 }
 
-void UEnhancedTickSystem::ProcessDeferredOperations()
+FComponentTypeBatch& UEnhancedTickSystem::FindOrAddBatch(UClass* Class)
 {
-    // Secure the locked block using shared pointer for thread safety
-    if (BatchesLock.IsValid())
-    {
-        FScopeLock Lock(BatchesLock.Get());
-        ProcessDeferredOperationsImpl();
-    }
-    else
+    FComponentTypeBatch*& Batch = TypeBatches.FindOrAdd(Class);
+    if (!Batch)
     {
-        ProcessDeferredOperationsImpl();
+        Batch = &BatchPool.Allocate();
     }
+    return *Batch;
 }
 
-// Internal implementation of deferred operations (called within lock)
+// Internal implementation of deferred operations (game thread, after the queue was drained)
 void UEnhancedTickSystem::ProcessDeferredOperationsImpl()
 {
+    // Collapse duplicate and conflicting requests: only the last request queued for an object is carried out
+    TMap<UObject*, uint32> LastRequests;
+    LastRequests.Reserve(PendingRegistrations.Num() + PendingUnregistrations.Num());
+    for (const FPendingRegistration& Registration : PendingRegistrations)
+    {
+        LastRequests.FindOrAdd(Registration.Object) = Registration.Serial;
+    }
+    for (const FPendingUnregistration& Unregistration : PendingUnregistrations)
+    {
+        uint32& LastSerial = LastRequests.FindOrAdd(Unregistration.Object);
+        LastSerial = FMath::Max(LastSerial, Unregistration.Serial);
+    }
+    
+    // A registration goes ahead when it is the last request and the object is not in a batch yet;
+    // a re-registration after an unregistration in the same frame keeps the existing entry
+    auto IsEffectiveRegistration = [this, &LastRequests](const FPendingRegistration& Registration)
+    {
+        return LastRequests.FindChecked(Registration.Object) == Registration.Serial && !RegisteredEntities.Contains(Registration.Object);
+    };
+    
+    // Count the pending registrations of each class, so a batch grows once for a bulk registration
+    TMap<UClass*, int32> PendingCounts;
+    if (PendingRegistrations.Num() > 1)
+    {
+        for (const FPendingRegistration& Registration : PendingRegistrations)
+        {
+            if (IsValid(Registration.Object) && IsEffectiveRegistration(Registration))
+            {
+                PendingCounts.FindOrAdd(Registration.Object->GetClass())++;
+            }
+        }
+    }
+    
+    auto ReservePending = [&PendingCounts](UClass* Class, FComponentTypeBatch& Batch)
+    {
+        int32 Count;
+        if (PendingCounts.RemoveAndCopyValue(Class, Count))
+        {
+            Batch.Entities.Reserve(Batch.Entities.Num() + Count);
+        }
+    };
+    
     // Process pending registrations
-    for (const auto& RegPair : PendingRegistrations)
+    for (const FPendingRegistration& Registration : PendingRegistrations)
     {
-        UObject* Object = RegPair.Key;
-        ETickBatchFlags Flags = RegPair.Value;
+        UObject* Object = Registration.Object;
+        ETickBatchFlags Flags = Registration.Flags;
         
-        if (!IsValid(Object))
+        if (!IsValid(Object) || !IsEffectiveRegistration(Registration))
         {
             continue;
         }
@@ -1154,43 +4649,78 @@ void UEnhancedTickSystem::ProcessDeferredOperationsImpl()
                 continue;
             }
             
-            FComponentTypeBatch& Batch = TypeBatches.FindOrAdd(ComponentClass);
+            FComponentTypeBatch& Batch = FindOrAddBatch(ComponentClass);
+            ReservePending(ComponentClass, Batch);
             
             // If the batch is created for the first time
             if (Batch.TypeName.IsEmpty())
             {
                 Batch.TypeName = ComponentClass->GetName();
-                Batch.TickGroup = Component->PrimaryComponentTick.TickGroup;
+                Batch.BatchClass = ComponentClass;
+                Batch.bGameThreadOnly = IsGameThreadOnlyClass(ComponentClass);
+                Batch.LODFrame = &LODFrame;
+                if (const FEnhancedBatchComputeFunction* ComputeFunction = RegisteredComputeKernels.Find(ComponentClass))
+                {
+                    Batch.BatchComputeFunction = *ComputeFunction;
+                }
+                if (const FEnhancedTickBatchSettings* Settings = BatchSettings.Find(ComponentClass))
+                {
+                    Batch.ApplySettings(*Settings);
+                }
+                Batch.TickGroup = FMath::Min<ETickingGroup>(Component->PrimaryComponentTick.TickGroup, TG_LastDemotable);
                 Batch.Flags = Flags;
+                Batch.UserFlags = Flags;
                 Batch.BatchTickFunction = DetermineBestTickFunction(ComponentClass);
+                Batch.bCustomTickFunction = RegisteredBatchKernels.Contains(ComponentClass);
+                if (!Batch.bCustomTickFunction && ComponentClass->IsChildOf(UCharacterMovementComponent::StaticClass()))
+                {
+                    Batch.SkipFunction = MakeCharacterMovementSkipFunction();
+                }
                 
                 // Add the batch to the appropriate tick group
                 GroupedBatches.FindOrAdd(Batch.TickGroup).Add(&Batch);
+                RegisterGroupTickFunction(Batch.TickGroup);
             }
             
             // Create tick data for the component
-            FTickEntityData EntityData;
-            EntityData.Object = Component;
-            EntityData.Position = Component->GetOwner() ? Component->GetOwner()->GetActorLocation() : FVector::ZeroVector;
-            EntityData.SpatialBucketId = CalculateSpatialBucketId(EntityData.Position);
-            EntityData.Priority = Component->PrimaryComponentTick.TickGroup == TG_PostPhysics ? 200 : 100;
-            EntityData.bEnabled = Component->IsActive();
+            const FVector Position = Component->GetOwner() ? Component->GetOwner()->GetActorLocation() : FVector::ZeroVector;
+            const uint8 Priority = Component->PrimaryComponentTick.TickGroup == TG_PostPhysics ? 200 : 100;
             
-            // Define a custom tick function for the component
-            EntityData.TickFunction = [Component](float DeltaTime) {
-                if (Component && Component->IsActive())
-                {
-                    Component->TickComponent(DeltaTime, ELevelTick::LEVELTICK_All, nullptr);
-                }
-            };
+            // A spatially aware registration makes the whole batch spatially aware, so grid membership stays per batch
+            if (EnumHasAnyFlags(Flags, ETickBatchFlags::SpatialAware))
+            {
+                EnableSpatialAwareness(Batch);
+            }
             
             // Add the component to the batch
-            Batch.TickEntities.Add(EntityData);
+            const FEnhancedTickHandle Handle = Batch.Entities.Add(Component, Position, Priority, Component->IsActive());
+            
+            // Per-entity tick functions are an opt-in fallback for custom tick targets only
+            if (Registration.CustomTickTarget && Registration.CustomTickFunction != NAME_None)
+            {
+                if (TFunction<void(float)> CustomTick = MakeCustomTickFunction(Registration.CustomTickTarget, Registration.CustomTickFunction))
+                {
+                    Batch.Entities.SetCustomTickFunction(Handle, MoveTemp(CustomTick));
+                    
+                    if (!Batch.bCustomTickFunction || RegisteredBatchKernels.Contains(ComponentClass))
+                    {
+                        Batch.BatchTickFunction = MakePerEntityTickFunction(ComponentClass);
+                        Batch.bCustomTickFunction = true;
+                    }
+                }
+            }
+            const int32 DenseIndex = Batch.Entities.FindDenseIndex(Handle);
+            Batch.Entities.SpatialBucketIds[DenseIndex] = CalculateSpatialBucketId(Position);
+            Batch.Entities.SortKeys[DenseIndex] = Batch.CalculateSortKey(Position);
+            Batch.Entities.RelevancyDistancesSq[DenseIndex] = GetNetRelevancyDistanceSquared(Component->GetOwner());
+            RegisteredEntities.Add(Component, FSpatialEntityRef(ComponentClass, Handle));
+            DisableNativeTick(Component);
+            BindLifetimeEvents(Component);
             
-            // For spatially aware components, also add them to the spatial batch
-            if (EnumHasAnyFlags(Flags, ETickBatchFlags::SpatialAware) && SpatialBatch.SpatialLock.IsValid())
+            // Entities of spatially aware batches are also added to the spatial batch
+            if (EnumHasAnyFlags(Batch.Flags, ETickBatchFlags::SpatialAware))
             {
-                SpatialBatch.AddEntity(&Batch.TickEntities.Last());
+                Batch.Entities.SpatialBucketIds[DenseIndex] = SpatialBatch.AddEntity(FSpatialEntityRef(ComponentClass, Handle), Position);
             }
             
             Stats.TotalRegisteredEntities++;
@@ -1204,51 +4734,58 @@ void UEnhancedTickSystem::ProcessDeferredOperationsImpl()
                 continue;
             }
             
-            FComponentTypeBatch& Batch = TypeBatches.FindOrAdd(ActorClass);
+            FComponentTypeBatch& Batch = FindOrAddBatch(ActorClass);
+            ReservePending(ActorClass, Batch);
             
             // If the batch is created for the first time
             if (Batch.TypeName.IsEmpty())
             {
                 Batch.TypeName = ActorClass->GetName();
-                Batch.TickGroup = Actor->PrimaryActorTick.TickGroup;
+                Batch.BatchClass = ActorClass;
+                Batch.bGameThreadOnly = IsGameThreadOnlyClass(ActorClass);
+                Batch.LODFrame = &LODFrame;
+                if (const FEnhancedBatchComputeFunction* ComputeFunction = RegisteredComputeKernels.Find(ActorClass))
+                {
+                    Batch.BatchComputeFunction = *ComputeFunction;
+                }
+                if (const FEnhancedTickBatchSettings* Settings = BatchSettings.Find(ActorClass))
+                {
+                    Batch.ApplySettings(*Settings);
+                }
+                Batch.TickGroup = FMath::Min<ETickingGroup>(Actor->PrimaryActorTick.TickGroup, TG_LastDemotable);
                 Batch.Flags = Flags;
-                Batch.BatchTickFunction = [](const TArrayView<FTickEntityData>& Entities, float DeltaTime) {
-                    for (const auto& Entity : Entities)
-                    {
-                        if (AActor* Actor = Cast<AActor>(Entity.Object))
-                        {
-                            Actor->Tick(DeltaTime);
-                        }
-                    }
-                };
+                Batch.UserFlags = Flags;
+                Batch.BatchTickFunction = DetermineBestTickFunction(ActorClass);
+                Batch.bCustomTickFunction = RegisteredBatchKernels.Contains(ActorClass);
                 
                 // Add the batch to the appropriate tick group
                 GroupedBatches.FindOrAdd(Batch.TickGroup).Add(&Batch);
+                RegisterGroupTickFunction(Batch.TickGroup);
             }
             
             // Create tick data for the actor
-            FTickEntityData EntityData;
-            EntityData.Object = Actor;
-            EntityData.Position = Actor->GetActorLocation();
-            EntityData.SpatialBucketId = CalculateSpatialBucketId(EntityData.Position);
-            EntityData.Priority = 100;
-            EntityData.bEnabled = Actor->IsActorTickEnabled();
+            const FVector Position = Actor->GetActorLocation();
             
-            // Define a custom tick function for the actor
-            EntityData.TickFunction = [Actor](float DeltaTime) {
-                if (Actor)
-                {
-                    Actor->Tick(DeltaTime);
-                }
-            };
+            // A spatially aware registration makes the whole batch spatially aware, so grid membership stays per batch
+            if (EnumHasAnyFlags(Flags, ETickBatchFlags::SpatialAware))
+            {
+                EnableSpatialAwareness(Batch);
+            }
             
-            // Add the actor to the batch
-            Batch.TickEntities.Add(EntityData);
+            // Add the actor to the batch; it starts in the state of its own tick, which is taken over below
+            const FEnhancedTickHandle Handle = Batch.Entities.Add(Actor, Position, 100, Actor->IsActorTickEnabled());
+            const int32 DenseIndex = Batch.Entities.FindDenseIndex(Handle);
+            Batch.Entities.SpatialBucketIds[DenseIndex] = CalculateSpatialBucketId(Position);
+            Batch.Entities.SortKeys[DenseIndex] = Batch.CalculateSortKey(Position);
+            Batch.Entities.RelevancyDistancesSq[DenseIndex] = GetNetRelevancyDistanceSquared(Actor);
+            RegisteredEntities.Add(Actor, FSpatialEntityRef(ActorClass, Handle));
+            DisableNativeTick(Actor);
+            BindLifetimeEvents(Actor);
             
-            // For spatially aware actors, also add them to the spatial batch
-            if (EnumHasAnyFlags(Flags, ETickBatchFlags::SpatialAware) && SpatialBatch.SpatialLock.IsValid())
+            // Entities of spatially aware batches are also added to the spatial batch
+            if (EnumHasAnyFlags(Batch.Flags, ETickBatchFlags::SpatialAware))
             {
-                SpatialBatch.AddEntity(&Batch.TickEntities.Last());
+                Batch.Entities.SpatialBucketIds[DenseIndex] = SpatialBatch.AddEntity(FSpatialEntityRef(ActorClass, Handle), Position);
             }
             
             Stats.TotalRegisteredEntities++;
@@ -1256,172 +4793,253 @@ void UEnhancedTickSystem::ProcessDeferredOperationsImpl()
     }
     
     // Process pending unregistrations
-    for (UObject* Object : PendingUnregistrations)
+    for (const FPendingUnregistration& Unregistration : PendingUnregistrations)
     {
-        if (!IsValid(Object))
+        UObject* Object = Unregistration.Object;
+        
+        // Objects already being destroyed can still be removed: the index is keyed by pointer only
+        FSpatialEntityRef Ref;
+        if (LastRequests.FindChecked(Object) != Unregistration.Serial || !RegisteredEntities.RemoveAndCopyValue(Object, Ref))
         {
             continue;
         }
         
-        // Remove the object from all batches
-        for (auto& Pair : TypeBatches)
+        FComponentTypeBatch* Batch = TypeBatches.FindRef(Ref.BatchClass);
+        const int32 DenseIndex = Batch ? Batch->Entities.FindDenseIndex(Ref.Handle) : INDEX_NONE;
+        if (DenseIndex == INDEX_NONE || Batch->Entities.Objects[DenseIndex] != Object)
         {
-            FComponentTypeBatch& Batch = Pair.Value;
-            
-            // Find and remove the matching entity
-            for (int32 i = 0; i < Batch.TickEntities.Num(); ++i)
-            {
-                if (Batch.TickEntities[i].Object == Object)
-                {
-                    // First, remove from the spatial batch
-                    if (SpatialBatch.SpatialLock.IsValid())
-                    {
-                        SpatialBatch.RemoveEntity(&Batch.TickEntities[i]);
-                    }
-                    
-                    // Then remove from the batch
-                    Batch.TickEntities.RemoveAt(i);
-                    Stats.TotalRegisteredEntities--;
-                    break;
-                }
-            }
+            continue;
+        }
+        
+        // First, remove from the spatial batch, using the same handle
+        SpatialBatch.RemoveEntity(Ref, Batch->Entities.SpatialBucketIds[DenseIndex]);
+        
+        // Then swap-remove from the batch; handles of the other entities stay valid
+        Batch->Entities.RemoveAtSwap(DenseIndex);
+        Stats.TotalRegisteredEntities--;
+        
+        // Objects removed at end of play or destruction only drop their record
+        if (Unregistration.bRestoreNativeTick)
+        {
+            RestoreNativeTick(Object);
+        }
+        else
+        {
+            NativeTickStates.Remove(Object);
+        }
+        
+        UnbindLifetimeEvents(Object);
+    }
+    
+    // Apply the enable state changes reported since the last frame, in order
+    for (const TPair<UObject*, bool>& Change : PendingEnableChanges)
+    {
+        const FSpatialEntityRef* Ref = RegisteredEntities.Find(Change.Key);
+        FComponentTypeBatch* Batch = Ref ? TypeBatches.FindRef(Ref->BatchClass) : nullptr;
+        const int32 DenseIndex = Batch ? Batch->Entities.FindDenseIndex(Ref->Handle) : INDEX_NONE;
+        if (DenseIndex != INDEX_NONE)
+        {
+            Batch->Entities.SetEnabled(DenseIndex, Change.Value);
         }
     }
     
-    // Clear the registration and unregistration queues
-    PendingRegistrations.Empty();
-    PendingUnregistrations.Empty();
+    // Clear the drained requests, keeping their memory; serials only order requests within one drain
+    PendingRegistrations.Reset();
+    PendingUnregistrations.Reset();
+    PendingEnableChanges.Reset();
+    NextRequestSerial = 0;
 }
 
-void UEnhancedTickSystem::UpdateBatchProfilingData(FComponentTypeBatch& Batch, float ExecutionTimeMs)
+void UEnhancedTickSystem::SetEntityTickEnabled(UObject* Object, bool bEnabled)
 {
-    // Update profiling data using exponential averaging (to smooth out sudden changes)
-    constexpr float Alpha = 0.2f; // Weight factor (0-1)
+    if (!IsValid(Object))
+    {
+        return;
+    }
     
-    Stats.TotalTickTimeMs += ExecutionTimeMs;
-    Stats.ActiveEntities += Batch.LastFrameTickCount;
+    QueueEnableChange(Object, bEnabled);
 }
 
-void UEnhancedTickSystem::UpdateConditionalTicks()
+void UEnhancedTickSystem::QueueRegistration(UObject* Object, ETickBatchFlags Flags, UObject* CustomTickTarget, FName CustomTickFunction)
 {
-    // Check conditional tick objects
-    for (auto& Pair : TypeBatches)
+    FDeferredOperation Operation;
+    Operation.Type = FDeferredOperation::EType::Register;
+    Operation.Object = Object;
+    Operation.Flags = Flags;
+    Operation.CustomTickTarget = CustomTickTarget;
+    Operation.CustomTickFunction = CustomTickFunction;
+    DeferredOperations.Enqueue(Operation);
+}
+
+void UEnhancedTickSystem::QueueUnregistration(UObject* Object, bool bRestoreNativeTick)
+{
+    FDeferredOperation Operation;
+    Operation.Type = FDeferredOperation::EType::Unregister;
+    Operation.Object = Object;
+    Operation.bEnabled = bRestoreNativeTick;
+    DeferredOperations.Enqueue(Operation);
+}
+
+void UEnhancedTickSystem::QueueEnableChange(UObject* Object, bool bEnabled)
+{
+    FDeferredOperation Operation;
+    Operation.Type = FDeferredOperation::EType::SetEnabled;
+    Operation.Object = Object;
+    Operation.bEnabled = bEnabled;
+    DeferredOperations.Enqueue(Operation);
+}
+
+void UEnhancedTickSystem::BindLifetimeEvents(UObject* Object)
+{
+    if (UActorComponent* Component = Cast<UActorComponent>(Object))
     {
-        FComponentTypeBatch& Batch = Pair.Value;
+        Component->OnComponentActivated.AddUniqueDynamic(this, &UEnhancedTickSystem::HandleComponentActivated);
+        Component->OnComponentDeactivated.AddUniqueDynamic(this, &UEnhancedTickSystem::HandleComponentDeactivated);
         
-        if (!EnumHasAnyFlags(Batch.Flags, ETickBatchFlags::Conditional))
+        // Components have no destruction event of their own; they leave with their owner
+        if (AActor* Owner = Component->GetOwner())
         {
-            continue;
+            Owner->OnEndPlay.AddUniqueDynamic(this, &UEnhancedTickSystem::HandleActorEndPlay);
+            Owner->OnDestroyed.AddUniqueDynamic(this, &UEnhancedTickSystem::HandleActorDestroyed);
         }
-        
-        // Update the status of objects with conditional ticks
-        for (auto& Entity : Batch.TickEntities)
+    }
+    else if (AActor* Actor = Cast<AActor>(Object))
+    {
+        Actor->OnEndPlay.AddUniqueDynamic(this, &UEnhancedTickSystem::HandleActorEndPlay);
+        Actor->OnDestroyed.AddUniqueDynamic(this, &UEnhancedTickSystem::HandleActorDestroyed);
+    }
+}
+
+void UEnhancedTickSystem::UnbindLifetimeEvents(UObject* Object)
+{
+    // Owner bindings stay while other components of the owner may still be registered; their handlers ignore unknown objects
+    if (!IsValid(Object))
+    {
+        return;
+    }
+    
+    if (UActorComponent* Component = Cast<UActorComponent>(Object))
+    {
+        Component->OnComponentActivated.RemoveDynamic(this, &UEnhancedTickSystem::HandleComponentActivated);
+        Component->OnComponentDeactivated.RemoveDynamic(this, &UEnhancedTickSystem::HandleComponentDeactivated);
+    }
+    else if (AActor* Actor = Cast<AActor>(Object))
+    {
+        Actor->OnEndPlay.RemoveDynamic(this, &UEnhancedTickSystem::HandleActorEndPlay);
+        Actor->OnDestroyed.RemoveDynamic(this, &UEnhancedTickSystem::HandleActorDestroyed);
+    }
+}
+
+void UEnhancedTickSystem::HandleComponentActivated(UActorComponent* Component, bool bReset)
+{
+    QueueEnableChange(Component, true);
+}
+
+void UEnhancedTickSystem::HandleComponentDeactivated(UActorComponent* Component)
+{
+    QueueEnableChange(Component, false);
+}
+
+void UEnhancedTickSystem::HandleActorEndPlay(AActor* Actor, EEndPlayReason::Type EndPlayReason)
+{
+    if (!Actor)
+    {
+        return;
+    }
+    
+    // Queued like any unregistration; a later OnDestroyed for the same actor collapses into it
+    if (RegisteredEntities.Contains(Actor))
+    {
+        QueueUnregistration(Actor, false);
+    }
+    
+    Actor->ForEachComponent(false, [this](UActorComponent* Component)
+    {
+        if (RegisteredEntities.Contains(Component))
         {
-            if (!IsValid(Entity.Object))
-            {
-                Entity.bEnabled = false;
-                continue;
-            }
-            
-            // For components, check if active
-            if (UActorComponent* Component = Cast<UActorComponent>(Entity.Object))
-            {
-                Entity.bEnabled = Component->IsActive();
-            }
-            // For actors, check if active (use IsValid instead of IsPendingKill in UE5)
-            else if (AActor* Actor = Cast<AActor>(Entity.Object))
-            {
-                Entity.bEnabled = IsValid(Actor) && Actor->IsActorTickEnabled();
-            }
+            QueueUnregistration(Component, false);
         }
-    }
+    });
+}
+
+void UEnhancedTickSystem::HandleActorDestroyed(AActor* Actor)
+{
+    HandleActorEndPlay(Actor, EEndPlayReason::Destroyed);
+}
+
+void UEnhancedTickSystem::UpdateBatchProfilingData(FComponentTypeBatch& Batch)
+{
+    // Frame totals, published at the start of the next frame
+    Stats.FrameTickTimeMs += Batch.GetLastFrameTimeMs();
+    Stats.FrameActiveEntities += Batch.LastFrameTickCount;
+    Stats.FrameBudgetDeferredEntities += Batch.LastFrameDeferredCount;
+    Stats.FrameCacheMissCount += Batch.LastFrameCounters.CacheMisses;
+    INC_DWORD_STAT_BY(STAT_EnhancedTick_CacheMisses, uint32(FMath::Min<uint64>(Batch.LastFrameCounters.CacheMisses, MAX_uint32)));
+    
+    Batch.RecordFrameHistory(FrameCounter);
 }
 
 void UEnhancedTickSystem::OptimizeCharacterMovementBatch(FComponentTypeBatch& Batch)
 {
-    // Special tick function for CharacterMovementComponent
-    Batch.BatchTickFunction = [](const TArrayView<FTickEntityData>& Entities, float DeltaTime)
+    // Special tick function for CharacterMovementComponent (unless the user installed their own)
+    if (!Batch.bCustomTickFunction)
     {
         // CharacterMovementComponents are not thread-safe due to transform updates;
-        // therefore, we process them sequentially.
-        
-        // Prefetch the first component if available
-        if (Entities.Num() > 0 && Entities[0].Object)
-        {
-            ENHANCED_TICK_PREFETCH_DATA(Entities[0].Object);
-        }
-        
-        // Process all components on a single thread - no parallel processing
-        for (int32 i = 0; i < Entities.Num(); ++i)
-        {
-            const FTickEntityData& Entity = Entities[i];
-            UCharacterMovementComponent* CMC = Cast<UCharacterMovementComponent>(Entity.Object);
-            
-            if (!CMC || !Entity.bEnabled)
-            {
-                continue;
-            }
-            
-            // Prefetch the next component if available
-            if (i + 1 < Entities.Num() && Entities[i + 1].Object)
-            {
-                ENHANCED_TICK_PREFETCH_DATA(Entities[i + 1].Object);
-            }
-            
-            // Tick the component (sequential processing)
-            CMC->TickComponent(DeltaTime, ELevelTick::LEVELTICK_All, nullptr);
-        }
-    };
+        // therefore, we process them sequentially on a single thread.
+        Batch.BatchTickFunction = MakeCharacterMovementKernel();
+        Batch.SkipFunction = MakeCharacterMovementSkipFunction();
+    }
     
-    // Disable parallel processing for CharacterMovementComponents
-    Batch.Flags &= ~ETickBatchFlags::UseParallel;
+    // Disable parallel processing for CharacterMovementComponents, unless they tick in two phases
+    if (!Batch.IsTwoPhase())
+    {
+        Batch.Flags &= ~ETickBatchFlags::UseParallel;
+    }
     
     // Enable spatial awareness for this group
-    Batch.Flags |= ETickBatchFlags::SpatialAware;
+    EnableSpatialAwareness(Batch);
 }
 
 void UEnhancedTickSystem::OptimizeAIPerceptionBatch(FComponentTypeBatch& Batch)
 {
-    // Optimized tick lambda for AIPerceptionComponent
-    Batch.BatchTickFunction = [this](const TArrayView<FTickEntityData>& Entities, float DeltaTime)
+    // Optimized tick lambda for AIPerceptionComponent (unless the user installed their own)
+    if (!Batch.bCustomTickFunction)
     {
-        // Special AI perception optimization
-        // Use spatial cell grouping to optimize overlapping perception regions
-        
-        // Prefetch the first component if available
-        if (Entities.Num() > 0 && Entities[0].Object)
-        {
-            ENHANCED_TICK_PREFETCH_DATA(Entities[0].Object);
-        }
-        
-        for (int32 i = 0; i < Entities.Num(); ++i)
+        Batch.BatchTickFunction = MakeEnhancedBatchKernel<UAIPerceptionComponent>([](UAIPerceptionComponent& PerceptionComp, float DeltaTime)
         {
-            const FTickEntityData& Entity = Entities[i];
-            UAIPerceptionComponent* PerceptionComp = Cast<UAIPerceptionComponent>(Entity.Object);
-            
-            if (!PerceptionComp || !Entity.bEnabled)
-            {
-                continue;
-            }
-            
-            // Prefetch the next component if available
-            if (i + 1 < Entities.Num() && Entities[i + 1].Object)
-            {
-                ENHANCED_TICK_PREFETCH_DATA(Entities[i + 1].Object);
-            }
-            
             // Tick the AI perception component
-            PerceptionComp->TickComponent(DeltaTime, ELevelTick::LEVELTICK_All, nullptr);
-            
-            // Find nearby AIs and share perception results (this part can be customized based on game logic)
-        }
-    };
+            PerceptionComp.TickComponent(DeltaTime, ELevelTick::LEVELTICK_All, nullptr);
+        });
+    }
     
     // Enable spatial awareness for this group
+    EnableSpatialAwareness(Batch);
+    
+    // Agents in the same cell share one neighbour candidate list (GetNeighbourCandidates) instead of each
+    // discovering its neighbours
+    Batch.bUsesNeighbourCache = true;
+}
+
+void UEnhancedTickSystem::EnableSpatialAwareness(FComponentTypeBatch& Batch)
+{
+    if (EnumHasAnyFlags(Batch.Flags, ETickBatchFlags::SpatialAware))
+    {
+        return;
+    }
+    
     Batch.Flags |= ETickBatchFlags::SpatialAware;
+    Stats.SpatialBatchCount++;
+    
+    // Grid membership follows the batch flag, so the entities registered so far join the grid now
+    FTickEntityStore& Store = Batch.Entities;
+    for (int32 DenseIndex = 0; DenseIndex < Store.Num(); ++DenseIndex)
+    {
+        Store.SpatialBucketIds[DenseIndex] = SpatialBatch.AddEntity(
+            FSpatialEntityRef(Batch.BatchClass, Store.GetHandle(DenseIndex)), Store.Positions[DenseIndex]);
+    }
 }
 
-uint16 UEnhancedTickSystem::CalculateSpatialBucketId(const FVector& Position)
+uint64 UEnhancedTickSystem::CalculateSpatialBucketId(const FVector& Position)
 {
     return SpatialBatch.CalculateGridCell(Position);
 }
@@ -1453,7 +5071,7 @@ void UEnhancedTickSystem::SortBatchesByPriority()
             }
             
             // For batches with equal priority, sort by the number of entities
-            return A.TickEntities.Num() > B.TickEntities.Num();
+            return A.Entities.Num() > B.Entities.Num();
         });
     }
 }
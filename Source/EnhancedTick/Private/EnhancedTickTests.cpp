@@ -0,0 +1,338 @@
+// Copyright (C) Thyke 2025 All Rights Reserved.
+
+#include "EnhancedTickSystem.h"
+#include "EnhancedTickBenchmarkCommandlet.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/WorldSettings.h"
+#include "Misc/AutomationTest.h"
+#include "UObject/Package.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#define ENHANCED_TICK_TEST_FLAGS (EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+//////////////////////////////////////////////////////////////////////////
+// Test helpers
+
+// Components outside of any world; the batch tests only need objects for the store
+static TArray<UEnhancedTickBenchmarkComponent*> CreateTestComponents(int32 Count)
+{
+    TArray<UEnhancedTickBenchmarkComponent*> Components;
+    Components.Reserve(Count);
+    for (int32 Index = 0; Index < Count; ++Index)
+    {
+        Components.Add(NewObject<UEnhancedTickBenchmarkComponent>(GetTransientPackage()));
+    }
+    return Components;
+}
+
+// Standalone batch of the given components, in registration order
+static void FillTestBatch(FComponentTypeBatch& Batch, const TArray<UEnhancedTickBenchmarkComponent*>& Components)
+{
+    Batch.BatchClass = UEnhancedTickBenchmarkComponent::StaticClass();
+    Batch.bSortByCacheLocality = false;
+    
+    for (int32 Index = 0; Index < Components.Num(); ++Index)
+    {
+        Batch.Entities.Add(Components[Index], FVector(Index * 100.0f, 0.0f, 0.0f), 0, true);
+    }
+}
+
+// Kernel counting the ticks of every object
+static FEnhancedBatchTickFunction MakeCountingKernel(TMap<const UObject*, int32>& Counts)
+{
+    return [&Counts](const FTickEntityStore& Store, TArrayView<const int32> Indices, float DeltaTime)
+    {
+        for (const int32 Index : Indices)
+        {
+            Counts.FindOrAdd(Store.Objects[Index])++;
+        }
+    };
+}
+
+// Tick the world for one frame and return how many entities of a class the system ticked in it
+static int32 TickAndCountBatchedEntities(UWorld* World, UEnhancedTickSystem* TickSystem, UClass* Class)
+{
+    TickSystem->ResetBatchStats();
+    World->Tick(LEVELTICK_All, 0.016f);
+    
+    FEnhancedTickBatchStats Stats;
+    return TickSystem->GetBatchStatsForClass(Class, Stats) && Stats.NumFrames > 0 ? FMath::RoundToInt(Stats.EntityCount.Max) : 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Entity store
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEnhancedTickStoreHandleTest, "EnhancedTick.Store.HandleGeneration", ENHANCED_TICK_TEST_FLAGS)
+
+bool FEnhancedTickStoreHandleTest::RunTest(const FString& Parameters)
+{
+    const TArray<UEnhancedTickBenchmarkComponent*> Components = CreateTestComponents(4);
+    
+    FTickEntityStore Store;
+    const FEnhancedTickHandle First = Store.Add(Components[0], FVector::ZeroVector, 0, true);
+    const FEnhancedTickHandle Second = Store.Add(Components[1], FVector::ZeroVector, 0, true);
+    const FEnhancedTickHandle Third = Store.Add(Components[2], FVector::ZeroVector, 0, true);
+    
+    // Removing the first entity swaps the last one into its dense index
+    TestTrue(TEXT("Remove succeeds for a live handle"), Store.Remove(First));
+    TestEqual(TEXT("Entities after remove"), Store.Num(), 2);
+    TestEqual(TEXT("Active entities after remove"), Store.NumActive(), 2);
+    TestEqual(TEXT("Removed handle is stale"), Store.FindDenseIndex(First), int32(INDEX_NONE));
+    TestFalse(TEXT("Remove fails for a stale handle"), Store.Remove(First));
+    
+    const int32 SecondIndex = Store.FindDenseIndex(Second);
+    const int32 ThirdIndex = Store.FindDenseIndex(Third);
+    TestTrue(TEXT("Second handle still resolves"), SecondIndex != INDEX_NONE && Store.Objects[SecondIndex] == Components[1]);
+    TestTrue(TEXT("Swapped handle still resolves"), ThirdIndex != INDEX_NONE && Store.Objects[ThirdIndex] == Components[2]);
+    TestTrue(TEXT("Swapped entity keeps its handle"), Store.GetHandle(ThirdIndex) == Third);
+    TestEqual(TEXT("Object lookup follows the swap"), Store.FindDenseIndex(Components[2]), ThirdIndex);
+    
+    // The freed slot is reused with a new generation, so the old handle never aliases the new entity
+    const FEnhancedTickHandle Reused = Store.Add(Components[3], FVector::ZeroVector, 0, true);
+    TestEqual(TEXT("Freed slot is reused"), Reused.Index, First.Index);
+    TestTrue(TEXT("Reused slot has a new generation"), Reused.Generation != First.Generation);
+    TestEqual(TEXT("Old handle stays stale after reuse"), Store.FindDenseIndex(First), int32(INDEX_NONE));
+    
+    const int32 ReusedIndex = Store.FindDenseIndex(Reused);
+    TestTrue(TEXT("New handle resolves to the new entity"), ReusedIndex != INDEX_NONE && Store.Objects[ReusedIndex] == Components[3]);
+    
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Batch scheduling
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEnhancedTickLowPrioPhaseTest, "EnhancedTick.Batch.LowPrioPhaseSplit", ENHANCED_TICK_TEST_FLAGS)
+
+bool FEnhancedTickLowPrioPhaseTest::RunTest(const FString& Parameters)
+{
+    constexpr int32 NumEntities = 64;
+    constexpr int32 Interval = 4;
+    
+    FComponentTypeBatch Batch;
+    FillTestBatch(Batch, CreateTestComponents(NumEntities));
+    Batch.Flags = ETickBatchFlags::LowPrio;
+    Batch.Settings.LowPriorityTickInterval = Interval;
+    
+    TMap<const UObject*, int32> Counts;
+    Batch.BatchTickFunction = MakeCountingKernel(Counts);
+    
+    FEnhancedTickLODFrame Frame;
+    Batch.LODFrame = &Frame;
+    
+    // An interval of N ticks an even 1/N of the entities every frame, and each of them once per N frames
+    for (int32 FrameIndex = 0; FrameIndex < Interval; ++FrameIndex)
+    {
+        Frame.FrameNumber = FrameIndex;
+        Frame.SimulationTime = FrameIndex * 0.1;
+        Batch.TickBatch(0.1f);
+        
+        TestEqual(FString::Printf(TEXT("Entities ticked in frame %d"), FrameIndex), Batch.LastFrameTickCount, NumEntities / Interval);
+    }
+    
+    TestEqual(TEXT("Entities ticked over one interval"), Counts.Num(), NumEntities);
+    for (const auto& Pair : Counts)
+    {
+        TestEqual(TEXT("Ticks per entity over one interval"), Pair.Value, 1);
+    }
+    
+    // The next round starts with the first phase again, and its entities get the time of the whole interval
+    Frame.FrameNumber = Interval;
+    Frame.SimulationTime = Interval * 0.1;
+    Batch.TickBatch(0.1f);
+    TestEqual(TEXT("Entities ticked in the first frame of the next interval"), Batch.LastFrameTickCount, NumEntities / Interval);
+    
+    for (int32 Index = 0; Index < NumEntities; ++Index)
+    {
+        if (Batch.Entities.LastTickTimes[Index] == Frame.SimulationTime)
+        {
+            TestEqual(TEXT("Delta time of an entity due once per interval"), Batch.Entities.EntityDeltaTimes[Index], Interval * 0.1f, KINDA_SMALL_NUMBER);
+        }
+    }
+    
+    // Batches that are not owned by a system tick every entity
+    Batch.LODFrame = nullptr;
+    Batch.TickBatch(0.1f);
+    TestEqual(TEXT("Entities ticked without a LOD frame"), Batch.LastFrameTickCount, NumEntities);
+    
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEnhancedTickBudgetCarryOverTest, "EnhancedTick.Batch.BudgetCarryOver", ENHANCED_TICK_TEST_FLAGS)
+
+bool FEnhancedTickBudgetCarryOverTest::RunTest(const FString& Parameters)
+{
+    constexpr int32 NumEntities = 25;
+    constexpr int32 Budget = 10;
+    
+    FComponentTypeBatch Batch;
+    FillTestBatch(Batch, CreateTestComponents(NumEntities));
+    Batch.TickBudgetEntities = Budget;
+    
+    TMap<const UObject*, int32> Counts;
+    Batch.BatchTickFunction = MakeCountingKernel(Counts);
+    
+    FEnhancedTickLODFrame Frame;
+    Batch.LODFrame = &Frame;
+    
+    auto TickFrame = [&Batch, &Frame](int32 FrameIndex)
+    {
+        Frame.FrameNumber = FrameIndex;
+        Frame.SimulationTime = (FrameIndex + 1) * 0.1;
+        Batch.TickBatch(0.1f);
+    };
+    
+    TickFrame(0);
+    TestEqual(TEXT("Entities ticked within the budget"), Batch.LastFrameTickCount, Budget);
+    TestEqual(TEXT("Entities deferred by the budget"), Batch.LastFrameDeferredCount, NumEntities - Budget);
+    
+    // What the budget passed over goes first, so nobody ticks twice before everyone ticked once
+    TickFrame(1);
+    TestEqual(TEXT("Distinct entities after two frames"), Counts.Num(), 2 * Budget);
+    
+    TickFrame(2);
+    TestEqual(TEXT("Distinct entities after three frames"), Counts.Num(), NumEntities);
+    for (const auto& Pair : Counts)
+    {
+        TestTrue(TEXT("No entity ticks twice while others wait"), Pair.Value <= 2);
+    }
+    
+    // Deferred entities get the real time since their last tick, over all the frames they waited
+    const TArray<double> PreviousTickTimes = Batch.Entities.LastTickTimes;
+    TickFrame(3);
+    
+    int32 NumCarriedOver = 0;
+    for (int32 Index = 0; Index < NumEntities; ++Index)
+    {
+        if (Batch.Entities.LastTickTimes[Index] == Frame.SimulationTime && PreviousTickTimes[Index] >= 0.0)
+        {
+            const float Elapsed = float(Frame.SimulationTime - PreviousTickTimes[Index]);
+            TestTrue(TEXT("A deferred entity waited more than one frame"), Elapsed > 0.15f);
+            TestEqual(TEXT("Delta time of a deferred entity"), Batch.Entities.EntityDeltaTimes[Index], Elapsed, KINDA_SMALL_NUMBER);
+            ++NumCarriedOver;
+        }
+    }
+    TestEqual(TEXT("Entities ticked after a deferral"), NumCarriedOver, Budget);
+    
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEnhancedTickParallelEquivalenceTest, "EnhancedTick.Batch.ParallelEquivalence", ENHANCED_TICK_TEST_FLAGS)
+
+bool FEnhancedTickParallelEquivalenceTest::RunTest(const FString& Parameters)
+{
+    constexpr int32 NumEntities = 1000;
+    constexpr int32 NumFrames = 8;
+    
+    const TArray<UEnhancedTickBenchmarkComponent*> SerialComponents = CreateTestComponents(NumEntities);
+    const TArray<UEnhancedTickBenchmarkComponent*> ParallelComponents = CreateTestComponents(NumEntities);
+    
+    // Distinct starting states, so entities ticked with the wrong object or twice show up
+    for (int32 Index = 0; Index < NumEntities; ++Index)
+    {
+        SerialComponents[Index]->Phase = ParallelComponents[Index]->Phase = Index * 0.01f;
+    }
+    
+    const FEnhancedBatchTickFunction Kernel = MakeEnhancedBatchKernel<UEnhancedTickBenchmarkComponent>(
+        [](UEnhancedTickBenchmarkComponent& Component, float DeltaTime)
+        {
+            Component.TickComponent(DeltaTime, LEVELTICK_All, nullptr);
+        });
+    
+    FComponentTypeBatch SerialBatch;
+    FillTestBatch(SerialBatch, SerialComponents);
+    SerialBatch.BatchTickFunction = Kernel;
+    
+    FComponentTypeBatch ParallelBatch;
+    FillTestBatch(ParallelBatch, ParallelComponents);
+    ParallelBatch.BatchTickFunction = Kernel;
+    ParallelBatch.Flags = ETickBatchFlags::UseParallel;
+    TestTrue(TEXT("Batch can tick in parallel"), ParallelBatch.CanTickInParallel());
+    
+    for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+    {
+        SerialBatch.TickBatch(0.016f);
+        ParallelBatch.TickBatchParallel(0.016f);
+        TestEqual(TEXT("Entities ticked in parallel"), ParallelBatch.LastFrameTickCount, SerialBatch.LastFrameTickCount);
+    }
+    
+    int32 NumMismatches = 0;
+    for (int32 Index = 0; Index < NumEntities; ++Index)
+    {
+        NumMismatches += (SerialComponents[Index]->Phase != ParallelComponents[Index]->Phase
+            || SerialComponents[Index]->Value != ParallelComponents[Index]->Value) ? 1 : 0;
+    }
+    TestEqual(TEXT("Entities whose parallel state differs from the serial one"), NumMismatches, 0);
+    
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Tick system
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FEnhancedTickRegistrationCollapseTest, "EnhancedTick.System.RegistrationCollapse", ENHANCED_TICK_TEST_FLAGS)
+
+bool FEnhancedTickRegistrationCollapseTest::RunTest(const FString& Parameters)
+{
+    UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("EnhancedTickTest"));
+    FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+    WorldContext.SetCurrentWorld(World);
+    World->InitializeActorsForPlay(FURL());
+    
+    UEnhancedTickSystem* TickSystem = World->GetSubsystem<UEnhancedTickSystem>();
+    if (TickSystem)
+    {
+        AActor* Actor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity);
+        UEnhancedTickBenchmarkComponent* Component = NewObject<UEnhancedTickBenchmarkComponent>(Actor);
+        Component->RegisterComponent();
+        
+        // Inactive components are registered disabled and would not show up in the ticked count
+        Component->Activate(true);
+        
+        World->BeginPlay();
+        if (!World->HasBegunPlay())
+        {
+            World->GetWorldSettings()->NotifyBeginPlay();
+        }
+        
+        UClass* Class = UEnhancedTickBenchmarkComponent::StaticClass();
+        
+        // Register then unregister within a frame: only the last request is carried out
+        TickSystem->RegisterComponent(Component);
+        TickSystem->UnregisterComponent(Component);
+        TestEqual(TEXT("Entities after register and unregister in one frame"), TickAndCountBatchedEntities(World, TickSystem, Class), 0);
+        TestTrue(TEXT("Native tick is restored"), Component->PrimaryComponentTick.bCanEverTick);
+        
+        TickSystem->RegisterComponent(Component);
+        TestEqual(TEXT("Entities after registration"), TickAndCountBatchedEntities(World, TickSystem, Class), 1);
+        
+        // Unregister then register again within a frame keeps the single entity
+        TickSystem->UnregisterComponent(Component);
+        TickSystem->RegisterComponent(Component);
+        TestEqual(TEXT("Entities after unregister and register in one frame"), TickAndCountBatchedEntities(World, TickSystem, Class), 1);
+        TestFalse(TEXT("Native tick stays disabled"), Component->PrimaryComponentTick.bCanEverTick);
+        
+        // Duplicate registrations collapse into one entity
+        TickSystem->RegisterComponent(Component);
+        TickSystem->RegisterComponent(Component);
+        TestEqual(TEXT("Entities after duplicate registrations"), TickAndCountBatchedEntities(World, TickSystem, Class), 1);
+        
+        TickSystem->UnregisterComponent(Component);
+        TestEqual(TEXT("Entities after unregistration"), TickAndCountBatchedEntities(World, TickSystem, Class), 0);
+    }
+    else
+    {
+        AddError(TEXT("No EnhancedTickSystem in the test world"));
+    }
+    
+    GEngine->DestroyWorldContext(World);
+    World->DestroyWorld(false);
+    
+    return true;
+}
+
+#undef ENHANCED_TICK_TEST_FLAGS
+
+#endif // WITH_DEV_AUTOMATION_TESTS
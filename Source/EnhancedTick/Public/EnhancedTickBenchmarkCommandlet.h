@@ -0,0 +1,51 @@
+// Copyright (C) Thyke 2025 All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "Components/ActorComponent.h"
+#include "EnhancedTickBenchmarkCommandlet.generated.h"
+
+/**
+ * Trivial component with a fixed amount of work per tick, used as the baseline population of the benchmark.
+ */
+UCLASS(ClassGroup = "Enhanced Tick System", meta = (BlueprintSpawnableComponent))
+class ENHANCEDTICK_API UEnhancedTickBenchmarkComponent : public UActorComponent
+{
+    GENERATED_BODY()
+
+public:
+    UEnhancedTickBenchmarkComponent();
+    
+    virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+    
+    // State advanced by every tick, so the work cannot be optimized away
+    float Phase;
+    float Value;
+};
+
+/**
+ * Headless benchmark comparing native ticking with EnhancedTick serial and parallel batches.
+ * Every combination of scenario, population and mode runs in a fresh game world; frame times and per-batch
+ * statistics are written to CSV files.
+ *
+ * Usage: UnrealEditor-Cmd <Project> -run=EnhancedTickBenchmark [options]
+ *   -Scenarios=CMC,Perception,Trivial   Populations to spawn
+ *   -Counts=1000,10000,50000            Components per population
+ *   -Modes=Native,Serial,Parallel       Tick modes
+ *   -Frames=300 -Warmup=30              Measured and discarded frames per run
+ *   -DeltaTime=0.0333                   Fixed frame delta time
+ *   -MovingFraction=0.5                 Share of the characters that receive movement input
+ *   -Output=<Dir>                       Defaults to Saved/Profiling/EnhancedTick
+ */
+UCLASS()
+class ENHANCEDTICK_API UEnhancedTickBenchmarkCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UEnhancedTickBenchmarkCommandlet();
+    
+    virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,98 @@
+// Copyright (C) Thyke 2025 All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include <atomic>
+#include "EnhancedTickScheduler.generated.h"
+
+class UEnhancedTickSystem;
+
+/**
+ * Process-wide arbiter of the tick systems of all worlds (game instances, PIE clients, server worlds, previews).
+ * Splits a global per-frame budget and the task graph workers between the worlds by weight: worlds with players
+ * weigh 1, worlds without any a configurable fraction. Parallel ticks of all worlds draw their helper tasks from
+ * one shared pool of worker slots, so worlds ticking at the same time no longer oversubscribe the machine.
+ */
+UCLASS()
+class ENHANCEDTICK_API UEnhancedTickScheduler : public UEngineSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    UEnhancedTickScheduler();
+    
+    virtual void Deinitialize() override;
+    
+    /**
+     * Caps the time the batches of all worlds may take per engine frame, on top of the budgets of each world.
+     * @param Milliseconds - Budget per frame, 0 to disable.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Enhanced Tick System|Scheduler")
+    void SetGlobalFrameBudget(float Milliseconds);
+    
+    /**
+     * Weight of worlds without players relative to worlds with players, for the budget and worker shares.
+     * @param Weight - 0 to 1; small values leave editor previews and empty server worlds little of the machine.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Enhanced Tick System|Scheduler")
+    void SetPlayerlessWorldWeight(float Weight);
+    
+    // Whether parallel ticks share the worker slots across worlds (on by default)
+    UFUNCTION(BlueprintCallable, Category = "Enhanced Tick System|Scheduler")
+    void SetWorkerSharing(bool bEnabled);
+    
+    UFUNCTION(BlueprintCallable, Category = "Enhanced Tick System|Scheduler")
+    int32 GetNumWorlds() const { return Worlds.Num(); }
+    
+    // Tick systems join and leave on their Initialize and Deinitialize (game thread)
+    void RegisterSystem(const UEnhancedTickSystem* System);
+    void UnregisterSystem(const UEnhancedTickSystem* System);
+    
+    // Start of the frame of a world: starts a new global frame if needed and updates the world's weight (game thread)
+    void BeginWorldFrame(const UEnhancedTickSystem* System, bool bHasPlayers);
+    
+    // Cycles the world may still spend this frame under the global budget, MAX_int64 without one
+    int64 GetRemainingCycles(const UEnhancedTickSystem* System) const;
+    
+    // Account cycles the world spent on its batches (game thread)
+    void ChargeCycles(const UEnhancedTickSystem* System, uint64 Cycles);
+    
+    // Maximum number of helper tasks one parallel tick of the world may use
+    int32 GetWorkerShare(const UEnhancedTickSystem* System) const;
+    
+    // Reserve up to Desired worker slots, at least Minimum even when all are taken. Any thread.
+    int32 AcquireWorkers(int32 Desired, int32 Minimum);
+    
+    // Return slots taken with AcquireWorkers, one per finished helper task. Any thread.
+    void ReleaseWorkers(int32 Num);
+
+private:
+    struct FWorldEntry
+    {
+        const UEnhancedTickSystem* System;
+        float Weight;
+        uint64 CyclesUsed;
+    };
+    
+    FWorldEntry* FindWorld(const UEnhancedTickSystem* System);
+    const FWorldEntry* FindWorld(const UEnhancedTickSystem* System) const;
+    
+    // Share of a world in the budget and the workers, 0 to 1
+    float GetWorldShare(const FWorldEntry& Entry) const { return TotalWeight > 0.0f ? Entry.Weight / TotalWeight : 1.0f; }
+    
+    TArray<FWorldEntry> Worlds;
+    float TotalWeight;
+    
+    float PlayerlessWorldWeight;
+    bool bShareWorkers;
+    
+    // Global budget in cycles (0 for none), and the frame it is currently counted for
+    uint64 GlobalBudgetCycles;
+    uint64 GlobalCyclesUsed;
+    uint64 BudgetFrame;
+    
+    // Helper tasks of all worlds currently holding a worker slot
+    std::atomic<int32> InFlightWorkers;
+};
@@ -9,17 +9,62 @@
 #include "Containers/StaticArray.h"
 #include "HAL/CriticalSection.h"
 #include "Async/TaskGraphInterfaces.h"
+#include "Containers/Queue.h"
+#include "Trace/Trace.h"
+#include "GameFramework/Actor.h"
+#include "Components/ActorComponent.h"
+#include <type_traits>
 #include "EnhancedTickSystem.generated.h"
 
+// Helper for prefetching data on platforms that support prefetching
+#if !UE_BUILD_SHIPPING && !UE_BUILD_TEST
+#define ENHANCED_TICK_PREFETCH_DATA(Ptr) FPlatformMisc::Prefetch(Ptr)
+#else
+#define ENHANCED_TICK_PREFETCH_DATA(Ptr)
+#endif
+
 // Define the stats group
 DECLARE_STATS_GROUP(TEXT("EnhancedTickSystem"), STATGROUP_EnhancedTick, STATCAT_Advanced);
 
 // Extern variable declarations for stats - definitions will be provided in the CPP file
 DECLARE_CYCLE_STAT_EXTERN(TEXT("Enhanced Tick - Total"), STAT_EnhancedTick_Total, STATGROUP_EnhancedTick, ENHANCEDTICK_API);
 DECLARE_CYCLE_STAT_EXTERN(TEXT("Enhanced Tick - Type Batches"), STAT_EnhancedTick_TypeBatches, STATGROUP_EnhancedTick, ENHANCEDTICK_API);
-DECLARE_CYCLE_STAT_EXTERN(TEXT("Enhanced Tick - Spatial Batches"), STAT_EnhancedTick_SpatialBatches, STATGROUP_EnhancedTick, ENHANCEDTICK_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Enhanced Tick - Position Refresh"), STAT_EnhancedTick_PositionRefresh, STATGROUP_EnhancedTick, ENHANCEDTICK_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Enhanced Tick - Neighbour Cache"), STAT_EnhancedTick_NeighbourCache, STATGROUP_EnhancedTick, ENHANCEDTICK_API);
 DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Enhanced Tick - Cache Misses"), STAT_EnhancedTick_CacheMisses, STATGROUP_EnhancedTick, ENHANCEDTICK_API);
 
+// Trace channel of the batch scopes and scheduling events (enable with -trace=cpu,EnhancedTick)
+UE_TRACE_CHANNEL_EXTERN(EnhancedTickChannel, ENHANCEDTICK_API);
+
+/**
+ * Scheduling decisions traced as EnhancedTick.SchedulingDecision events, with the batch name and two values.
+ */
+enum class EEnhancedTickTraceDecision : uint8
+{
+    // Value: entities whose LOD tick interval changed this frame, Detail: entities under the LOD
+    LODTierChange,
+    
+    // Value: entities held back by the budget, Detail: entities the budget allowed
+    BudgetOverrun,
+    
+    // A parallel batch ticked on the game thread. Value: EEnhancedTickSerialFallback, Detail: active entities
+    SerialFallback,
+    
+    // The optimizer changed the batch flags. Value: old ETickBatchFlags, Detail: new ETickBatchFlags
+    FlagChange,
+    
+    // The adaptive optimizer switched the execution mode.
+    // Value: bit 0 parallel, bit 1 cache sort, bits 2+ grain scale in percent; Detail: measured gain in percent
+    ModeChange,
+};
+
+// Why a parallel batch ticked serially
+enum class EEnhancedTickSerialFallback : uint8
+{
+    GameThreadOnly,
+    TooFewEntities,
+};
+
 // Define tick properties as bitflags
 UENUM(BlueprintType, meta = (Bitflags))
 enum class ETickBatchFlags : uint8
@@ -36,27 +81,699 @@ enum class ETickBatchFlags : uint8
 ENUM_CLASS_FLAGS(ETickBatchFlags);
 
 /**
- * Tick data required for a single instance of a component type.
- * Contains only the necessary data and is designed to be cache-friendly.
+ * Generational handle to an entity stored in an FTickEntityStore.
+ * Stays valid while other entities are added, removed or reordered; a handle to a removed
+ * entity is detected through its generation and never resolves to a recycled slot.
+ */
+struct FEnhancedTickHandle
+{
+    uint32 Index;       // Slot index in the owning store
+    uint32 Generation;  // Generation of the slot at the time the handle was issued
+    
+    FEnhancedTickHandle() : Index(uint32(INDEX_NONE)), Generation(0) {}
+    FEnhancedTickHandle(uint32 InIndex, uint32 InGeneration) : Index(InIndex), Generation(InGeneration) {}
+    
+    bool IsValid() const { return Index != uint32(INDEX_NONE); }
+    void Invalidate() { Index = uint32(INDEX_NONE); Generation = 0; }
+    
+    bool operator==(const FEnhancedTickHandle& Other) const { return Index == Other.Index && Generation == Other.Generation; }
+    bool operator!=(const FEnhancedTickHandle& Other) const { return !(*this == Other); }
+    
+    friend uint32 GetTypeHash(const FEnhancedTickHandle& Handle)
+    {
+        return HashCombine(::GetTypeHash(Handle.Index), ::GetTypeHash(Handle.Generation));
+    }
+};
+
+/**
+ * Slot-map storage for all entities of a batch.
+ * Every field lives in its own contiguous column indexed by a dense index, so tick loops only
+ * stream the columns they actually read. Removal swaps the last entity into the hole, and the
+ * sparse slot table keeps handles pointing at the right dense index.
+ */
+struct ENHANCEDTICK_API FTickEntityStore
+{
+    // Hot columns
+    TArray<UObject*> Objects;                       // The object to be ticked (Actor or Component)
+    TArray<FVector> Positions;                      // World position (for spatial batching)
+    TArray<uint8> Priorities;                       // Tick priority (0-255)
+    TBitArray<> EnabledFlags;                       // Is it enabled?
+    
+    // Cold columns
+    TArray<uint64> SpatialBucketIds;                // Spatial grid cell key (FSpatialEntityBatch::FCellKey)
+    TArray<uint64> SortKeys;                        // Morton code of the quantized position (cache locality order)
+    TArray<double> LastTickTimes;                   // Simulation time of the last tick, negative if none yet
+    TArray<float> EntityDeltaTimes;                 // Time since the previous tick, for the current tick
+    TArray<int32> LODIntervals;                     // Tick interval picked by the LOD last frame, 0 if none yet
+    TArray<float> RelevancyDistancesSq;             // Squared net cull distance of the owning actor, MAX_flt if always relevant
+    TArray<uint32> DenseToSlot;                     // Reverse mapping used to patch slots on swap
+    
+    // Packed dense indices of all enabled entities, kept in dense order after each re-sort.
+    // Updated incrementally on enable/disable, add and remove, so ticking never has to filter.
+    TArray<int32> ActiveIndices;
+    TArray<int32> DenseToActive;                    // Position in ActiveIndices, or INDEX_NONE
+    
+    // Set whenever membership changes and the dense order no longer matches SortKeys
+    bool bOrderDirty;
+    
+    // Set while a system tick is running: kernels take the per-entity delta from EntityDeltaTimes
+    bool bUseEntityDeltaTimes;
+    
+    FTickEntityStore() : bOrderDirty(false), bUseEntityDeltaTimes(false) {}
+    
+    // Delta time to pass to the entity: the time since its last tick (LOD, low priority or budget may skip frames)
+    float GetDeltaTime(int32 DenseIndex, float FrameDeltaTime) const
+    {
+        return bUseEntityDeltaTimes ? EntityDeltaTimes[DenseIndex] : FrameDeltaTime;
+    }
+    
+    int32 Num() const { return Objects.Num(); }
+    bool IsValidIndex(int32 DenseIndex) const { return Objects.IsValidIndex(DenseIndex); }
+    
+    bool IsEnabled(int32 DenseIndex) const { return EnabledFlags[DenseIndex]; }
+    void SetEnabled(int32 DenseIndex, bool bEnabled);
+    
+    // Zero-copy view of the enabled entities
+    TArrayView<const int32> GetActiveIndices() const { return ActiveIndices; }
+    int32 NumActive() const { return ActiveIndices.Num(); }
+    
+    // Rebuild the active list in ascending dense order
+    void RebuildActiveIndices();
+    
+    // Add a new entity and return its handle
+    FEnhancedTickHandle Add(UObject* Object, const FVector& Position, uint8 Priority, bool bEnabled);
+    
+    // Opt-in per-entity tick functions, keyed by slot so they never move with the dense columns
+    void SetCustomTickFunction(FEnhancedTickHandle Handle, TFunction<void(float)>&& TickFunction);
+    const TFunction<void(float)>* FindCustomTickFunction(int32 DenseIndex) const { return CustomTickFunctions.Find(DenseToSlot[DenseIndex]); }
+    
+    // Remove an entity by handle (swap-remove). Returns false for stale handles.
+    bool Remove(FEnhancedTickHandle Handle);
+    
+    // Remove the entity at a dense index (swap-remove)
+    void RemoveAtSwap(int32 DenseIndex);
+    
+    // Resolve a handle to its current dense index, or INDEX_NONE if stale
+    int32 FindDenseIndex(FEnhancedTickHandle Handle) const;
+    
+    // Linear search for an object, returns INDEX_NONE if not found
+    int32 FindDenseIndex(const UObject* Object) const;
+    
+    // Build the handle for the entity currently at a dense index
+    FEnhancedTickHandle GetHandle(int32 DenseIndex) const;
+    
+    // Swap two entities in every column, keeping their handles valid
+    void SwapEntities(int32 DenseIndexA, int32 DenseIndexB);
+    
+    // Reorder all columns in place so that the entity previously at NewOrder[i] ends up at i.
+    // Location and Occupant are caller-owned scratch, so steady-state re-sorts do not allocate.
+    void ApplyPermutation(TArrayView<const int32> NewOrder, TArray<int32>& Location, TArray<int32>& Occupant);
+    
+    void Reserve(int32 Number);
+    void Empty();
+    
+    // Heap memory of all columns, the slot table and the custom tick functions
+    SIZE_T GetAllocatedSize() const;
+    
+private:
+    struct FSlot
+    {
+        int32 DenseIndex;   // INDEX_NONE while the slot is free
+        uint32 Generation;
+    };
+    
+    TArray<FSlot> Slots;
+    TArray<uint32> FreeSlots;
+    
+    // Sparse per-entity tick functions (only entities registered with a custom tick target)
+    TMap<uint32, TFunction<void(float)>> CustomTickFunctions;
+};
+
+// Batch tick function: receives the batch storage and the dense indices to tick this frame.
+// Implementations should pass Store.GetDeltaTime(DenseIndex, DeltaTime) to each entity so LOD ticks get their accumulated time.
+typedef TFunction<void(const FTickEntityStore&, TArrayView<const int32>, float)> FEnhancedBatchTickFunction;
+
+// Batch skip function: whether an entity that is due in a frame (dense index, LOD frame number) has nothing to do.
+// Skipped entities keep their last tick time, so the skipped time carries over to their next tick.
+typedef TFunction<bool(const FTickEntityStore&, int32, uint64)> FEnhancedBatchSkipFunction;
+
+/**
+ * Builds a type-specialized batch loop for objects of type TObject.
+ * The kernel is called as Kernel(TObject&, float DeltaTime) and is inlined into the loop, so the only
+ * indirect call left is the one per batch. Objects are static_cast, without a per-element Cast<>.
+ */
+template<typename TObject, typename TKernel>
+FEnhancedBatchTickFunction MakeEnhancedBatchKernel(TKernel Kernel)
+{
+    return [Kernel](const FTickEntityStore& Store, TArrayView<const int32> Indices, float DeltaTime)
+    {
+        UObject* const* Objects = Store.Objects.GetData();
+        const int32 Num = Indices.Num();
+        
+        for (int32 i = 0; i < Num; ++i)
+        {
+            // Prefetch the next object while the current one ticks
+            if (i + 1 < Num)
+            {
+                ENHANCED_TICK_PREFETCH_DATA(Objects[Indices[i + 1]]);
+            }
+            
+            TObject* Object = static_cast<TObject*>(Objects[Indices[i]]);
+            if (IsValid(Object))
+            {
+                Kernel(*Object, Store.GetDeltaTime(Indices[i], DeltaTime));
+            }
+        }
+    };
+}
+
+/**
+ * Game thread writes recorded by the compute phase of a two-phase batch.
+ * Each parallel chunk records into its own buffer; the buffers are applied on the game thread in chunk order,
+ * transform commands before deferred ones.
  */
-struct FTickEntityData
+struct ENHANCEDTICK_API FEnhancedTickCommandBuffer
 {
-    UObject* Object;                      // The object to be ticked (Actor or Component)
-    TFunction<void(float)> TickFunction;  // Tick lambda function
-    FVector Position;                     // World position (for spatial batching)
-    uint16 SpatialBucketId;               // Spatial cell ID (grid-based)
-    uint8 Priority;                       // Tick priority (0-255)
-    bool bEnabled;                        // Is it enabled?
+    // Move a scene component (applied with SetWorldLocationAndRotation)
+    void SetWorldLocationAndRotation(USceneComponent* Component, const FVector& Location, const FQuat& Rotation);
+    
+    // Any other change that must happen on the game thread
+    void Defer(TFunction<void()>&& Command);
+    
+    // Commit the recorded commands and clear the buffer
+    void Apply();
+    
+    // Drop the recorded commands, keeping the allocations
+    void Reset();
+    
+    bool IsEmpty() const { return TransformCommands.Num() == 0 && DeferredCommands.Num() == 0; }
     
-    FTickEntityData() : Object(nullptr), SpatialBucketId(0), Priority(128), bEnabled(true) {}
+    SIZE_T GetAllocatedSize() const { return TransformCommands.GetAllocatedSize() + DeferredCommands.GetAllocatedSize(); }
     
-    // Calculates the distance between two tick entities (for cache locality)
-    float GetDistance(const FTickEntityData& Other) const
+private:
+    struct FTransformCommand
+    {
+        USceneComponent* Component;
+        FVector Location;
+        FQuat Rotation;
+    };
+    
+    TArray<FTransformCommand> TransformCommands;
+    TArray<TFunction<void()>> DeferredCommands;
+};
+
+// Compute phase of a two-phase batch: runs on worker threads and records game thread writes into the buffer
+typedef TFunction<void(const FTickEntityStore&, TArrayView<const int32>, float, FEnhancedTickCommandBuffer&)> FEnhancedBatchComputeFunction;
+
+/**
+ * Builds the compute loop of a two-phase batch for objects of type TObject.
+ * The kernel is called as Kernel(TObject&, float DeltaTime, FEnhancedTickCommandBuffer&). It may run on any
+ * thread, so it must only read scene state and record its writes into the command buffer.
+ */
+template<typename TObject, typename TKernel>
+FEnhancedBatchComputeFunction MakeEnhancedComputeKernel(TKernel Kernel)
+{
+    return [Kernel](const FTickEntityStore& Store, TArrayView<const int32> Indices, float DeltaTime, FEnhancedTickCommandBuffer& Commands)
+    {
+        UObject* const* Objects = Store.Objects.GetData();
+        const int32 Num = Indices.Num();
+        
+        for (int32 i = 0; i < Num; ++i)
+        {
+            // Prefetch the next object while the current one computes
+            if (i + 1 < Num)
+            {
+                ENHANCED_TICK_PREFETCH_DATA(Objects[Indices[i + 1]]);
+            }
+            
+            TObject* Object = static_cast<TObject*>(Objects[Indices[i]]);
+            if (IsValid(Object))
+            {
+                Kernel(*Object, Store.GetDeltaTime(Indices[i], DeltaTime), Commands);
+            }
+        }
+    };
+}
+
+/**
+ * Default kernel: calls TObject's own Tick/TickComponent non-virtually.
+ * Only valid for batches whose class is exactly TObject.
+ */
+template<typename TObject>
+struct TEnhancedTickDefaultKernel
+{
+    void operator()(TObject& Object, float DeltaTime) const
     {
-        return FVector::Distance(Position, Other.Position);
+        if constexpr (TIsDerivedFrom<TObject, AActor>::Value)
+        {
+            Object.TObject::Tick(DeltaTime);
+        }
+        else if (Object.IsActive())
+        {
+            Object.TObject::TickComponent(DeltaTime, ELevelTick::LEVELTICK_All, nullptr);
+        }
     }
 };
 
+/**
+ * Distance band of the tick LOD: entities within MaxDistance of the nearest viewer tick every TickInterval frames.
+ */
+USTRUCT(BlueprintType)
+struct ENHANCEDTICK_API FEnhancedTickLODBand
+{
+    GENERATED_BODY()
+    
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Enhanced Tick System")
+    float MaxDistance;
+    
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Enhanced Tick System", meta = (ClampMin = "1"))
+    int32 TickInterval;
+    
+    FEnhancedTickLODBand()
+        : MaxDistance(0.0f)
+        , TickInterval(1)
+    {}
+    
+    FEnhancedTickLODBand(float InMaxDistance, int32 InTickInterval)
+        : MaxDistance(InMaxDistance)
+        , TickInterval(InTickInterval)
+    {}
+};
+
+/**
+ * Per-class scheduling options of a batch, set through UEnhancedTickSystem::SetBatchSettings.
+ */
+USTRUCT(BlueprintType)
+struct ENHANCEDTICK_API FEnhancedTickBatchSettings
+{
+    GENERATED_BODY()
+    
+    // Dispatch the batch to worker threads in its tick group without waiting, and join it in JoinTickGroup.
+    // Only used for batches that can tick in parallel.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Enhanced Tick System")
+    bool bDeferredJoin;
+    
+    // Tick group whose system tick function joins the dispatched batch. That function is registered with the settings
+    // and is high priority, so it runs ahead of the game thread tick functions of the group. Tick functions that run
+    // on worker threads are not ordered against it: give them GetGroupTickFunction(JoinTickGroup) as a prerequisite.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Enhanced Tick System", meta = (EditCondition = "bDeferredJoin"))
+    TEnumAsByte<ETickingGroup> JoinTickGroup;
+    
+    // Data the batch reads, as free-form tags (e.g. "Perception"). Batches that only read the same data can run concurrently.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Enhanced Tick System|Dependencies")
+    TArray<FName> Reads;
+    
+    // Data the batch writes. A batch never runs concurrently with another one that reads or writes the same tag.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Enhanced Tick System|Dependencies")
+    TArray<FName> Writes;
+    
+    // Batches of the same tick group that must have finished before this one starts
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Enhanced Tick System|Dependencies")
+    TArray<TSubclassOf<UObject>> TickAfter;
+    
+    // Tick rate tiers by distance to the nearest local player view, e.g. {2000, 1}, {5000, 2}, {10000, 4}.
+    // Empty disables the tick LOD. Skipped entities get the accumulated delta time when they tick.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Enhanced Tick System|LOD")
+    TArray<FEnhancedTickLODBand> LODBands;
+    
+    // Tick interval of entities beyond the last band
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Enhanced Tick System|LOD", meta = (ClampMin = "1"))
+    int32 LODFarTickInterval;
+    
+    // LowPrio batches tick each entity every this many frames, staggered so that a share of the batch ticks every frame
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Enhanced Tick System", meta = (ClampMin = "1"))
+    int32 LowPriorityTickInterval;
+    
+    // Hold a per-batch lock around serial ticks, for kernels that share state with other threads.
+    // Off by default: the tick path takes no locks.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Enhanced Tick System")
+    bool bLockTicks;
+    
+    // Let the optimizer sample execution modes (serial, parallel grains, cache sort on/off) and keep the fastest.
+    // Batches with a deferred join are never sampled.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Enhanced Tick System|Optimizer")
+    bool bAdaptiveMode;
+    
+    // Hard pin: the batch never ticks in parallel, whatever its flags or the optimizer say
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Enhanced Tick System|Optimizer")
+    bool bNeverParallel;
+    
+    // The batch only does presentation work (effects, animation polish, UI); it is skipped entirely on dedicated servers
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Enhanced Tick System|Server")
+    bool bCosmetic;
+    
+    // On servers, entities that no connected player can see (beyond the net cull distance of their actor from
+    // every player view) tick every this many frames. 1 disables the throttling.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Enhanced Tick System|Server", meta = (ClampMin = "1"))
+    int32 IrrelevantTickInterval;
+    
+    FEnhancedTickBatchSettings()
+        : bDeferredJoin(false)
+        , JoinTickGroup(TG_PostPhysics)
+        , LODFarTickInterval(8)
+        , LowPriorityTickInterval(3)
+        , bLockTicks(false)
+        , bAdaptiveMode(true)
+        , bNeverParallel(false)
+        , bCosmetic(false)
+        , IrrelevantTickInterval(1)
+    {}
+    
+    bool IsTickLODEnabled() const { return LODBands.Num() > 0; }
+    
+    // Batches without declared dependencies keep running one after another on the game thread
+    bool HasDeclaredDependencies() const
+    {
+        return Reads.Num() > 0 || Writes.Num() > 0 || TickAfter.Num() > 0;
+    }
+};
+
+/**
+ * Nearest-rank percentiles of a value over the statistics window of a batch.
+ */
+USTRUCT(BlueprintType)
+struct ENHANCEDTICK_API FEnhancedTickPercentiles
+{
+    GENERATED_BODY()
+    
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Enhanced Tick System")
+    float P50;
+    
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Enhanced Tick System")
+    float P95;
+    
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Enhanced Tick System")
+    float P99;
+    
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Enhanced Tick System")
+    float Max;
+    
+    FEnhancedTickPercentiles()
+        : P50(0.0f)
+        , P95(0.0f)
+        , P99(0.0f)
+        , Max(0.0f)
+    {}
+};
+
+/**
+ * One of the slowest entities of a batch within the statistics window.
+ */
+USTRUCT(BlueprintType)
+struct ENHANCEDTICK_API FEnhancedTickEntityOutlier
+{
+    GENERATED_BODY()
+    
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Enhanced Tick System")
+    UObject* Object;
+    
+    // Cost of the slowest sampled tick of the entity (microseconds)
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Enhanced Tick System")
+    float CostUs;
+    
+    // Number of frames since that tick
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Enhanced Tick System")
+    int32 FramesAgo;
+    
+    FEnhancedTickEntityOutlier()
+        : Object(nullptr)
+        , CostUs(0.0f)
+        , FramesAgo(0)
+    {}
+};
+
+/**
+ * Rolling statistics of a batch over its last ticked frames, returned by UEnhancedTickSystem::GetBatchStats.
+ */
+USTRUCT(BlueprintType)
+struct ENHANCEDTICK_API FEnhancedTickBatchStats
+{
+    GENERATED_BODY()
+    
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Enhanced Tick System")
+    UClass* BatchClass;
+    
+    // Number of ticked frames the percentiles are taken over
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Enhanced Tick System")
+    int32 NumFrames;
+    
+    // CPU time of the whole batch per frame, summed over the threads that ticked it (milliseconds)
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Enhanced Tick System")
+    FEnhancedTickPercentiles BatchTimeMs;
+    
+    // Average cost of one entity per frame (nanoseconds)
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Enhanced Tick System")
+    FEnhancedTickPercentiles EntityCostNs;
+    
+    // Number of entities ticked per frame
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Enhanced Tick System")
+    FEnhancedTickPercentiles EntityCount;
+    
+    // Last level cache misses per ticked entity, zero unless hardware counters are enabled
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Enhanced Tick System|Hardware Counters")
+    FEnhancedTickPercentiles CacheMissesPerEntity;
+    
+    // Instructions retired per CPU cycle, zero unless hardware counters are enabled
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Enhanced Tick System|Hardware Counters")
+    FEnhancedTickPercentiles InstructionsPerCycle;
+    
+    // Slowest sampled entities of the window, slowest first
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Enhanced Tick System")
+    TArray<FEnhancedTickEntityOutlier> Outliers;
+    
+    FEnhancedTickBatchStats()
+        : BatchClass(nullptr)
+        , NumFrames(0)
+    {}
+};
+
+/**
+ * Memory footprint of a batch, returned by UEnhancedTickSystem::GetMemoryReport.
+ */
+USTRUCT(BlueprintType)
+struct ENHANCEDTICK_API FEnhancedTickBatchMemory
+{
+    GENERATED_BODY()
+    
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Enhanced Tick System")
+    UClass* BatchClass;
+    
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Enhanced Tick System")
+    int32 NumEntities;
+    
+    // Entity columns, slot table and custom tick functions (bytes)
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Enhanced Tick System")
+    int64 EntityBytes;
+    
+    // Buffers reused across frames: sort scratch, LOD and budget index lists, command buffers, samples (bytes)
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Enhanced Tick System")
+    int64 ScratchBytes;
+    
+    // The batch object in the pool, including its statistics window (bytes)
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Enhanced Tick System")
+    int64 BatchBytes;
+    
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Enhanced Tick System")
+    int64 TotalBytes;
+    
+    // Total bytes divided by the allocated entity capacity, for sizing larger populations
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Enhanced Tick System")
+    float BytesPerEntity;
+    
+    FEnhancedTickBatchMemory()
+        : BatchClass(nullptr)
+        , NumEntities(0)
+        , EntityBytes(0)
+        , ScratchBytes(0)
+        , BatchBytes(0)
+        , TotalBytes(0)
+        , BytesPerEntity(0.0f)
+    {}
+};
+
+// Shared state of a parallel tick (chunk cursor, timings), defined in the implementation
+struct FEnhancedParallelTickState;
+
+class UEnhancedTickScheduler;
+
+struct FSpatialEntityBatch;
+
+/**
+ * Per-frame input of the tick throttling (LOD, low priority phases, budget), owned by the system and shared by all batches.
+ */
+struct FEnhancedTickLODFrame
+{
+    // View locations of the local players; on servers, of every connected player
+    TArray<FVector> ViewLocations;
+    
+    // Net mode of the world: servers throttle irrelevant entities, dedicated servers skip cosmetic batches
+    bool bIsServer;
+    bool bDedicatedServer;
+    
+    // Sum of the frame delta times, used to accumulate the delta of skipped entities
+    double SimulationTime;
+    
+    uint64 FrameNumber;
+    
+    // Grid the distances are measured on
+    const FSpatialEntityBatch* Grid;
+    
+    // Process-wide scheduler the worker slots of parallel ticks come from, and this world's share of them
+    UEnhancedTickScheduler* Scheduler;
+    int32 WorkerShare;
+    
+    FEnhancedTickLODFrame() : bIsServer(false), bDedicatedServer(false), SimulationTime(0.0), FrameNumber(0), Grid(nullptr), Scheduler(nullptr), WorkerShare(0) {}
+};
+
+/** An entity timed on its own during a tick, one per chunk, feeding the outlier tracking */
+struct FEnhancedTickEntitySample
+{
+    int32 DenseIndex;
+    uint64 Cycles;
+    
+    FEnhancedTickEntitySample() : DenseIndex(INDEX_NONE), Cycles(0) {}
+};
+
+/** Hardware performance counter totals of a tick, zero unless UEnhancedTickSystem::SetHardwareCountersEnabled is on */
+struct FEnhancedTickHardwareCounters
+{
+    uint64 Cycles;
+    uint64 Instructions;
+    uint64 CacheMisses;
+    
+    FEnhancedTickHardwareCounters() : Cycles(0), Instructions(0), CacheMisses(0) {}
+    
+    FEnhancedTickHardwareCounters& operator+=(const FEnhancedTickHardwareCounters& Other)
+    {
+        Cycles += Other.Cycles;
+        Instructions += Other.Instructions;
+        CacheMisses += Other.CacheMisses;
+        return *this;
+    }
+};
+
+/**
+ * Fixed-size rolling window of the per-frame timings of a batch and its slowest sampled entities.
+ * Recording never allocates; percentiles are only computed when the statistics are read.
+ */
+struct ENHANCEDTICK_API FEnhancedTickBatchHistory
+{
+    // Number of ticked frames kept in the window
+    static constexpr int32 NumFrames = 128;
+    
+    // Number of slowest entities kept
+    static constexpr int32 NumOutliers = 8;
+    
+    struct FOutlier
+    {
+        TWeakObjectPtr<UObject> Object;
+        float CostNs;
+        uint64 Frame;
+        
+        FOutlier() : CostNs(0.0f), Frame(0) {}
+    };
+    
+    // Ring buffers, indexed by frame modulo NumFrames
+    TStaticArray<float, NumFrames> BatchTimesMs;
+    TStaticArray<float, NumFrames> EntityCostsNs;
+    TStaticArray<int32, NumFrames> EntityCounts;
+    TStaticArray<float, NumFrames> CacheMissesPerEntity;
+    TStaticArray<float, NumFrames> InstructionsPerCycle;
+    
+    // Next slot to be written and number of valid slots
+    int32 Head;
+    int32 NumSamples;
+    
+    TStaticArray<FOutlier, NumOutliers> Outliers;
+    
+    FEnhancedTickBatchHistory() : Head(0), NumSamples(0) {}
+    
+    void AddFrame(float BatchTimeMs, float EntityCostNs, int32 EntityCount, const FEnhancedTickHardwareCounters& Counters);
+    
+    // Keep the entity if it is slower than the cheapest outlier, or if an outlier left the window
+    void AddOutlier(UObject* Object, float CostNs, uint64 Frame);
+    
+    void Reset();
+    
+    // Percentiles of the window and the outliers still alive and within it
+    void GetStats(uint64 CurrentFrame, FEnhancedTickBatchStats& OutStats) const;
+};
+
+/** An execution mode the adaptive optimizer can sample for a batch */
+struct FEnhancedTickBatchMode
+{
+    bool bParallel;
+    bool bSorted;
+    
+    // Multiplier of the measured parallel grain size
+    float GrainScale;
+    
+    FEnhancedTickBatchMode() : bParallel(false), bSorted(true), GrainScale(1.0f) {}
+    FEnhancedTickBatchMode(bool bInParallel, bool bInSorted, float InGrainScale) : bParallel(bInParallel), bSorted(bInSorted), GrainScale(InGrainScale) {}
+    
+    bool operator==(const FEnhancedTickBatchMode& Other) const
+    {
+        return bParallel == Other.bParallel && bSorted == Other.bSorted && GrainScale == Other.GrainScale;
+    }
+    
+    // Compact form used in the trace events
+    int32 Encode() const { return (bParallel ? 1 : 0) | (bSorted ? 2 : 0) | (FMath::RoundToInt(GrainScale * 100.0f) << 2); }
+};
+
+/**
+ * A/B sampling state of the adaptive optimizer for one batch.
+ * The chosen mode (the incumbent) runs most of the time; every few windows each other candidate runs for one
+ * window, and the wall time per entity decides. A challenger only takes over after beating the incumbent by a
+ * margin in consecutive rounds, so noise cannot make the mode flap.
+ */
+struct FEnhancedTickAdaptiveState
+{
+    static constexpr int32 MaxCandidates = 8;
+    
+    TStaticArray<FEnhancedTickBatchMode, MaxCandidates> Candidates;
+    
+    // Smoothed wall time per entity of each candidate (nanoseconds), negative until measured
+    TStaticArray<double, MaxCandidates> ScoresNs;
+    
+    int32 NumCandidates;
+    
+    // Candidate applied right now, and the one chosen
+    int32 Current;
+    int32 Incumbent;
+    
+    // Candidate that beat the incumbent in the last rounds, and how many rounds in a row
+    int32 Challenger;
+    int32 ChallengerWins;
+    
+    // Next candidate to sample while a round is running, INDEX_NONE between rounds
+    int32 ExploreCursor;
+    
+    // Incumbent windows left before the next round
+    int32 WindowsUntilRound;
+    
+    // Measurement of the current window
+    int32 WindowFrames;
+    uint64 WindowCycles;
+    int64 WindowEntities;
+    
+    // Whether parallel candidates were allowed when the list was built
+    bool bBuiltWithParallel;
+    
+    FEnhancedTickAdaptiveState()
+        : NumCandidates(0)
+        , Current(0)
+        , Incumbent(0)
+        , Challenger(INDEX_NONE)
+        , ChallengerWins(0)
+        , ExploreCursor(INDEX_NONE)
+        , WindowsUntilRound(1)
+        , WindowFrames(0)
+        , WindowCycles(0)
+        , WindowEntities(0)
+        , bBuiltWithParallel(false)
+    {}
+};
+
 /**
  * A batch for components of the same type.
  * Optimized for data cache alignment.
@@ -64,152 +781,761 @@ struct FTickEntityData
 USTRUCT()
 struct ENHANCEDTICK_API FComponentTypeBatch
 {
-    GENERATED_BODY()
-    
-    // Type name (for debugging)
-    FString TypeName;
-    
-    // Batch flags
-    ETickBatchFlags Flags;
-    
-    // Lock for parallel processing (using TSharedPtr since FCriticalSection cannot be copied)
-    TSharedPtr<FCriticalSection> BatchLock;
+    GENERATED_BODY()
+    
+    // Type name (for debugging)
+    FString TypeName;
+    
+    // Class of the batched objects
+    UClass* BatchClass;
+    
+    // Scheduling options
+    FEnhancedTickBatchSettings Settings;
+    
+    // Batch flags
+    ETickBatchFlags Flags;
+    
+    // Flags given at registration. Priorities set here are pins the optimizer does not change.
+    ETickBatchFlags UserFlags;
+    
+    // Lock held around serial ticks, only created when Settings.bLockTicks is set
+    // (using TSharedPtr since FCriticalSection cannot be copied)
+    TSharedPtr<FCriticalSection> BatchLock;
+    
+    // All objects to be ticked
+    FTickEntityStore Entities;
+    
+    // Function to trigger ticks for this group
+    FEnhancedBatchTickFunction BatchTickFunction;
+    
+    // Leaves out entities with nothing to do before their tick time is taken (e.g. idle characters); needs a LODFrame
+    FEnhancedBatchSkipFunction SkipFunction;
+    
+    // Tick group
+    ETickingGroup TickGroup;
+    
+    // Average processing time per tick function (in nanoseconds)
+    float AverageTickTimeNs;
+    
+    // Number of entities ticked in the last frame
+    int32 LastFrameTickCount;
+    
+    // Whether to use reordering based on cache sorting
+    bool bSortByCacheLocality;
+    
+    // The tick function was chosen by the user (registered kernel or per-entity fallback); optimizers keep it
+    bool bCustomTickFunction;
+    
+    // Quantization step used to build the Morton sort keys (world units)
+    float CacheSortCellSize;
+    
+    // The class touches scene state (transforms, movement), so its tick function is not run off the game thread
+    bool bGameThreadOnly;
+    
+    // Compute phase of a two-phase batch. When set it replaces BatchTickFunction: it runs in parallel even for
+    // game thread only classes, and its command buffers are applied on the game thread afterwards.
+    FEnhancedBatchComputeFunction BatchComputeFunction;
+    
+    // Viewers and time of the current frame, used when Settings enable tick LOD
+    const FEnhancedTickLODFrame* LODFrame;
+    
+    // The cells of this batch's entities get a shared neighbour candidate list every frame (e.g. AI perception)
+    bool bUsesNeighbourCache;
+    
+    // Maximum number of entities the frame budget allows in the next tick, INDEX_NONE for no limit
+    int32 TickBudgetEntities;
+    
+    // Number of entities held back by the budget in the last frame
+    int32 LastFrameDeferredCount;
+    
+    // Completion event of an asynchronous tick that has not been joined yet
+    FGraphEventRef AsyncCompletionEvent;
+    
+    // State of the in-flight asynchronous tick
+    TSharedPtr<FEnhancedParallelTickState> AsyncTickState;
+    
+    // Rolling timings and outliers of the ticked frames
+    FEnhancedTickBatchHistory History;
+    
+    // Hardware counters of the last tick, summed over the participating threads
+    FEnhancedTickHardwareCounters LastFrameCounters;
+    
+    // Wall time of the last serial or parallel tick, including the cache sort
+    uint64 LastFrameWallCycles;
+    
+    // Multiplier of the measured parallel grain size, chosen by the adaptive optimizer
+    float ParallelGrainScale;
+    
+    // Execution mode sampling of the adaptive optimizer
+    FEnhancedTickAdaptiveState Adaptive;
+    
+    FComponentTypeBatch() 
+        : BatchClass(nullptr)
+        , Flags(ETickBatchFlags::None)
+        , UserFlags(ETickBatchFlags::None)
+        , TickGroup(TG_PrePhysics)
+        , AverageTickTimeNs(0.0f)
+        , LastFrameTickCount(0)
+        , bSortByCacheLocality(true)
+        , bCustomTickFunction(false)
+        , CacheSortCellSize(500.0f)
+        , bGameThreadOnly(false)
+        , LODFrame(nullptr)
+        , bUsesNeighbourCache(false)
+        , TickBudgetEntities(INDEX_NONE)
+        , LastFrameDeferredCount(0)
+        , LastFrameWallCycles(0)
+        , ParallelGrainScale(1.0f)
+    {}
+    
+    // Batches live at a fixed address in the pool of their tick system and are never copied
+    FComponentTypeBatch(const FComponentTypeBatch&) = delete;
+    FComponentTypeBatch& operator=(const FComponentTypeBatch&) = delete;
+    FComponentTypeBatch(FComponentTypeBatch&&) = default;
+    FComponentTypeBatch& operator=(FComponentTypeBatch&&) = default;
+    
+    // Returns whether the batch supports parallel ticking
+    bool CanTickInParallel() const
+    {
+        return EnumHasAnyFlags(Flags, ETickBatchFlags::UseParallel) && !Settings.bNeverParallel;
+    }
+    
+    // Tick the batch (sequential processing)
+    void TickBatch(float DeltaTime);
+    
+    // Tick the batch (parallel processing)
+    void TickBatchParallel(float DeltaTime);
+    
+    // Dispatch the batch to worker threads without waiting. Returns false if it had to tick synchronously.
+    bool TickBatchAsync(float DeltaTime);
+    
+    // Join an asynchronous tick: the calling thread helps with the remaining chunks, then waits
+    void WaitForAsyncTick();
+    
+    // Whether an asynchronous tick is in flight
+    bool IsAsyncTickPending() const { return AsyncCompletionEvent.IsValid(); }
+    
+    // Reorder entities based on cache locality (only when the order has been invalidated)
+    void SortForCacheLocality();
+    
+    // Update the position of an entity; invalidates the cache order if it moved to another sort cell
+    void UpdateEntityPosition(int32 DenseIndex, const FVector& NewPosition);
+    
+    // Morton (Z-order) key of a position quantized to CacheSortCellSize
+    uint64 CalculateSortKey(const FVector& Position) const;
+    
+    // Tick a set of entities with dynamically claimed chunks on the workers and the calling thread.
+    // Returns the CPU cycles spent by all participants.
+    uint64 TickIndicesParallel(TArrayView<const int32> Indices, float DeltaTime);
+    
+    // Chunk size derived from the measured per-entity cost
+    int32 CalculateParallelGrainSize(int32 NumEntities, int32 NumParticipants) const;
+    
+    // Whether the whole batch may be ticked from a worker thread
+    bool CanTickOffGameThread() const;
+    
+    // Whether the batch ticks in two phases (parallel compute, game thread apply)
+    bool IsTwoPhase() const { return static_cast<bool>(BatchComputeFunction); }
+    
+    // Read the current world positions of the active entities in parallel and append the ones that moved.
+    // Only the position column is written; sort keys and grid cells are left to the caller.
+    void GatherEntityPositions(TArray<int32>& OutMovers);
+    
+    // Tick interval of an entity at a position, from the LOD bands and the nearest viewer
+    int32 GetLODTickInterval(const FVector& Position) const;
+    
+    // Take over scheduling options, creating the batch lock only if they ask for one
+    void ApplySettings(const FEnhancedTickBatchSettings& InSettings);
+    
+    // CPU time of the last tick, summed over the participating threads (milliseconds)
+    float GetLastFrameTimeMs() const { return AverageTickTimeNs * LastFrameTickCount * 1.0e-6f; }
+    
+    // Add the last tick and its entity samples to the history. Called on the game thread once the tick is complete.
+    void RecordFrameHistory(uint64 FrameNumber);
+    
+    // Feed the last serial or parallel tick to the adaptive optimizer and switch candidates at window ends.
+    // Returns true when a new execution mode was chosen, with the measured gain over the previous one.
+    bool UpdateAdaptiveMode(float& OutGainPercent);
+    
+    // Memory held by the batch; BatchClass and the totals are filled in as well
+    void GetMemoryFootprint(FEnhancedTickBatchMemory& OutMemory) const;
+    
+private:
+    // Whether the parallel paths have to fall back to ticking on the game thread
+    bool MustTickOnGameThread() const { return bGameThreadOnly && !IsTwoPhase(); }
+    
+    // Candidate modes for this batch; the current configuration is always the first one
+    void BuildAdaptiveCandidates(bool bAllowParallel);
+    
+    void ApplyBatchMode(const FEnhancedTickBatchMode& Mode);
+    
+    // Run the kernel over a set of entities on the calling thread; two-phase batches apply their commands right away
+    void TickIndicesSerial(TArrayView<const int32> Indices, float DeltaTime);
+    
+    // Apply the command buffers filled by the chunks of a two-phase tick, in chunk order
+    void ApplyCommandBuffers(int32 NumChunks);
+    
+    // Entities to tick this frame: the active list, or the subset whose LOD interval is due and that fits the budget,
+    // with their delta times set
+    TArrayView<const int32> GatherTickIndices(float DeltaTime);
+    
+    // Squared distance from the grid cell of an entity to the nearest player view, computed once per cell and frame.
+    // Never more than the distance of the entity itself.
+    float GetClientDistanceSquared(int32 DenseIndex);
+    
+    // Set up a parallel tick and dispatch its helper tasks
+    TSharedRef<FEnhancedParallelTickState> LaunchParallelTick(TArrayView<const int32> Indices, float DeltaTime, bool bCallerParticipates, FGraphEventArray& OutHelperTasks);
+
+    // Scratch buffers for the radix sort, kept to avoid reallocating on every re-sort
+    TArray<uint64> SortScratchKeys;
+    TArray<int32> SortScratchOrder;
+    TArray<uint64> SortTempKeys;
+    TArray<int32> SortTempOrder;
+    
+    // Second scratch of the in-place permutation, next to SortTempOrder
+    TArray<int32> SortTempLocations;
+    
+    // One command buffer per parallel chunk of a two-phase tick, reused across frames
+    TArray<FEnhancedTickCommandBuffer> ChunkCommandBuffers;
+    
+    // Entities selected by the tick LOD and the budget for the current frame
+    TArray<int32> LODTickIndices;
+    TArray<int32> BudgetTickIndices;
+    
+    // Nearest player view per grid cell for the relevancy throttling, rebuilt every frame
+    TMap<uint64, float> ClientCellDistancesSq;
+    
+    // Movers found by each chunk of the position gather
+    TArray<TArray<int32>> ChunkMovers;
+    
+    // Entity timed on its own by each chunk of the last tick, consumed by RecordFrameHistory
+    TArray<FEnhancedTickEntitySample> ChunkSamples;
+};
+
+template<>
+struct TStructOpsTypeTraits<FComponentTypeBatch> : public TStructOpsTypeTraitsBase2<FComponentTypeBatch>
+{
+    enum
+    {
+        WithCopy = false
+    };
+};
+
+/**
+ * One chunk of a data lane, handed to the lane kernel.
+ * Columns start on a 64-byte boundary, chunks start on a multiple of FEnhancedTickDataLane::ChunkSize and every
+ * column is padded to a multiple of four elements, so a kernel may load and store whole float vectors, tail included.
+ */
+struct FEnhancedTickDataChunk
+{
+    // First element of the chunk in the lane, and the number of elements
+    int32 First;
+    int32 Num;
+    
+    // Time since the chunk last ticked; the LOD, low priority phases and the budget may skip frames
+    float DeltaTime;
+    
+    // Spatial grid of the world, for read-only neighbour queries against the registered entities
+    const FSpatialEntityBatch* Grid;
+    
+    // Base pointers of the lane columns
+    uint8* const* ColumnData;
+    
+    // First element of the chunk in a column
+    template<typename T>
+    T* GetColumn(int32 Column) const { return reinterpret_cast<T*>(ColumnData[Column]) + First; }
+};
+
+// Kernel of a data lane, called once per chunk. Chunks of a lane may run on several threads at once.
+typedef TFunction<void(const FEnhancedTickDataChunk&)> FEnhancedDataLaneKernel;
+
+/**
+ * Simulation entities without UObjects (crowds, projectiles, ambient life): plain data in structure-of-arrays
+ * columns, ticked chunk by chunk by a single kernel, on the worker threads by default.
+ * Columns 0 to 2 are the float X, Y and Z positions used by the tick LOD; the lane's own columns are added with
+ * AddColumn before the first element. Removal swaps the last element into the hole, so indices are not stable.
+ */
+struct ENHANCEDTICK_API FEnhancedTickDataLane
+{
+    static constexpr int32 PositionX = 0;
+    static constexpr int32 PositionY = 1;
+    static constexpr int32 PositionZ = 2;
+    
+    // Elements per chunk, the unit of ticking, LOD and budget
+    static constexpr int32 ChunkSize = 256;
+    
+    FName Name;
+    
+    // Name of the lane in the trace, converted once by UEnhancedTickSystem::AddDataLane
+    FString TraceName;
+    
+    FEnhancedDataLaneKernel Kernel;
+    
+    ETickingGroup TickGroup;
+    
+    // UseParallel (set by default), HighPrio (exempt from the budget) and LowPrio are honoured
+    ETickBatchFlags Flags;
+    
+    // Rolling timings of the ticked frames; entity costs are per element
+    FEnhancedTickBatchHistory History;
+    
+    // Per-frame input shared with the batches of the owning system
+    const FEnhancedTickLODFrame* LODFrame;
+    
+    // Elements ticked and held back by the budget in the last frame
+    int32 LastFrameTickCount;
+    int32 LastFrameDeferredCount;
+    
+    // Measured CPU time of one element (nanoseconds), summed over the participating threads
+    float AverageElementTimeNs;
+    
+    FEnhancedTickHardwareCounters LastFrameCounters;
+    
+    FEnhancedTickDataLane();
+    
+    FEnhancedTickDataLane(const FEnhancedTickDataLane&) = delete;
+    FEnhancedTickDataLane& operator=(const FEnhancedTickDataLane&) = delete;
+    
+    // Add a column of plain data, returns its index. Only allowed while the lane is empty.
+    template<typename T>
+    int32 AddColumn()
+    {
+        static_assert(std::is_trivially_copyable<T>::value && std::is_trivially_destructible<T>::value, "Data lane columns hold plain data");
+        static_assert(alignof(T) <= 64, "Data lane columns are 64-byte aligned");
+        return AddColumnBytes(sizeof(T));
+    }
+    
+    int32 AddColumnBytes(int32 ElementSize);
+    
+    template<typename T>
+    TArrayView<T> GetColumn(int32 Column)
+    {
+        check(Columns[Column].ElementSize == sizeof(T));
+        return TArrayView<T>(reinterpret_cast<T*>(ColumnPointers[Column]), NumElements);
+    }
+    
+    int32 Num() const { return NumElements; }
+    int32 NumColumns() const { return Columns.Num(); }
+    
+    // The LOD bands, the low priority interval and bCosmetic apply; the LOD measures from the bounds of each chunk
+    void SetSettings(const FEnhancedTickBatchSettings& InSettings);
+    const FEnhancedTickBatchSettings& GetSettings() const { return Settings; }
+    
+    // Append zeroed elements, returns the index of the first one
+    int32 AddElements(int32 Count);
+    
+    // Remove an element by moving the last one into its place
+    void RemoveAtSwap(int32 Index);
+    
+    void Empty();
+    
+    // Tick the chunks that are due this frame, as many as fit into the remaining cycles (MAX_int64 for no limit)
+    void Tick(float DeltaTime, int64 RemainingCycles);
+    
+    float GetLastFrameTimeMs() const { return AverageElementTimeNs * LastFrameTickCount * 1.0e-6f; }
+    
+    // Add the last tick to the history (game thread)
+    void RecordFrameHistory();
+    
+    SIZE_T GetAllocatedSize() const;
+    
+private:
+    struct FColumn
+    {
+        int32 ElementSize;
+        TArray<uint8, TAlignedHeapAllocator<64>> Data;
+    };
+    
+    // Set the element count: grows the columns to it, padded to whole float vectors, and never shrinks them
+    void ResizeColumns(int32 NewNum);
+    
+    // LOD bands sorted by distance, see SetSettings
+    FEnhancedTickBatchSettings Settings;
+    
+    // Tick interval of a chunk from the LOD bands and the distance of its bounds to the nearest view
+    int32 GetChunkLODInterval(int32 Chunk) const;
+    
+    TArray<FColumn> Columns;
+    TArray<uint8*> ColumnPointers;
+    int32 NumElements;
+    
+    // Per chunk: simulation time of the last tick (negative if none yet) and the position bounds after it
+    TArray<double> ChunkLastTickTimes;
+    TArray<FBox3f> ChunkBounds;
+    
+    // Chunks selected for the current frame and their delta times
+    TArray<int32> TickChunks;
+    TArray<float> TickDeltaTimes;
+};
+
+/**
+ * Builds a kernel that moves the elements of a lane by their velocity, four at a time.
+ * The velocity lives in three float columns starting at VelocityColumn (X, Y, Z).
+ */
+ENHANCEDTICK_API FEnhancedDataLaneKernel MakeDataLaneIntegrateKernel(int32 VelocityColumn);
+
+/**
+ * Reference to an entity owned by a type batch.
+ * Batches are keyed by class, and the handle survives reallocation of the batch storage.
+ */
+struct FSpatialEntityRef
+{
+    UClass* BatchClass;
+    FEnhancedTickHandle Handle;
+    
+    FSpatialEntityRef() : BatchClass(nullptr) {}
+    FSpatialEntityRef(UClass* InBatchClass, FEnhancedTickHandle InHandle) : BatchClass(InBatchClass), Handle(InHandle) {}
+    
+    bool operator==(const FSpatialEntityRef& Other) const { return BatchClass == Other.BatchClass && Handle == Other.Handle; }
+};
+
+/** A radius query of a batched spatial lookup */
+struct FSpatialQuery
+{
+    FVector Position;
+    float Radius;
+    
+    FSpatialQuery() : Position(FVector::ZeroVector), Radius(0.0f) {}
+    FSpatialQuery(const FVector& InPosition, float InRadius) : Position(InPosition), Radius(InRadius) {}
+};
+
+/**
+ * Results of a batched spatial lookup.
+ * Keep one around between lookups: the results and the scratch of the lookup reuse their memory.
+ */
+struct ENHANCEDTICK_API FSpatialQueryResults
+{
+    // The entities found by query i are Entities[Offsets[i]] up to Entities[Offsets[i + 1]]
+    TArray<int32> Offsets;
+    TArray<FSpatialEntityRef> Entities;
+    
+    int32 NumQueries() const { return FMath::Max(Offsets.Num() - 1, 0); }
+    
+    TArrayView<const FSpatialEntityRef> GetResults(int32 QueryIndex) const
+    {
+        return TArrayView<const FSpatialEntityRef>(Entities.GetData() + Offsets[QueryIndex], Offsets[QueryIndex + 1] - Offsets[QueryIndex]);
+    }
+    
+private:
+    friend struct FSpatialEntityBatch;
+    
+    struct FCellQuery
+    {
+        int32 CellIndex;
+        int32 QueryIndex;
+    };
+    
+    struct FQueryHit
+    {
+        int32 QueryIndex;
+        FSpatialEntityRef Ref;
+    };
+    
+    // Occupied cells overlapped by each query, grouped by cell, and where each cell's run starts
+    TArray<FCellQuery> CellQueries;
+    TArray<int32> CellRuns;
+    
+    // Hits of each parallel chunk of cells, and the write cursors used to scatter them per query
+    TArray<TArray<FQueryHit>> ChunkHits;
+    TArray<int32> WriteCursors;
+};
+
+/**
+ * Spatial batch for groups of entities with spatial awareness.
+ * Processes nearby entities together using a sparse hash grid: only occupied cells exist, keyed by their
+ * full 64-bit cell coordinates, so distant cells never alias. The entries of all cells live in one pool,
+ * each cell owning a contiguous range of it. Positions are kept as float lanes relative to the cell origin,
+ * so radius queries compare four entries at a time without losing precision in large worlds.
+ * The grid is only changed on the game thread at the start of the frame, so neither changes nor queries lock.
+ */
+USTRUCT()
+struct ENHANCEDTICK_API FSpatialEntityBatch
+{
+    GENERATED_BODY()
+    
+    // Cell key: hierarchy level in the top 4 bits, then 20 bits per axis of the biased cell coordinates
+    typedef uint64 FCellKey;
+    
+    // Bits per axis in a key; coordinates are clamped to +-2^19 cells
+    static constexpr int32 CellAxisBits = 20;
+    
+    // An occupied cell and its range in the entry pool
+    struct FGridCell
+    {
+        FCellKey Key;
+        int32 Start;
+        int32 Num;
+        int32 Capacity;
+    };
+    
+    // Grid cell size
+    float GridCellSize;
+    
+    // Number of coarser occupancy levels above the grid (each doubling the cell size), 0 for a flat grid.
+    // Lets large-radius queries skip empty regions instead of visiting every cell in range.
+    int32 NumHierarchyLevels;
+    
+    // Entries of all cells as parallel columns: the entity references and the cell-relative position lanes.
+    // Ranges of removed or relocated cells stay unused until the pool is compacted.
+    TArray<FSpatialEntityRef> EntryRefs;
+    TArray<float> EntryX;
+    TArray<float> EntryY;
+    TArray<float> EntryZ;
+    
+    // Occupied cells, in no particular order
+    TArray<FGridCell> Cells;
+    
+    // Index into Cells by key
+    TMap<FCellKey, int32> CellLookup;
+    
+    // Entity counts of the occupied coarse cells, one map per hierarchy level
+    TArray<TMap<FCellKey, int32>> LevelCounts;
+    
+    // Number of spatial entities across all cells
+    int32 NumSpatialEntities;
+    
+    // Pool entries not owned by any cell
+    int32 NumWastedEntries;
+    
+    FSpatialEntityBatch() 
+        : GridCellSize(1000.0f)
+        , NumHierarchyLevels(0)
+        , NumSpatialEntities(0)
+        , NumWastedEntries(0)
+    {}
+    
+    // The grid is owned by its tick system and never copied
+    FSpatialEntityBatch(const FSpatialEntityBatch&) = delete;
+    FSpatialEntityBatch& operator=(const FSpatialEntityBatch&) = delete;
+    FSpatialEntityBatch(FSpatialEntityBatch&&) = default;
+    FSpatialEntityBatch& operator=(FSpatialEntityBatch&&) = default;
+    
+    // Change the grid layout; only allowed while the grid is empty
+    void Configure(float InGridCellSize, int32 InNumHierarchyLevels);
+    
+    bool IsEmpty() const { return Cells.Num() == 0; }
+    
+    // Remove all entities and release the pool, the cells and the level counts in one go
+    void Empty();
+    
+    // Heap memory of the entry pool, the cells and the lookups
+    SIZE_T GetAllocatedSize() const;
+    
+    // Calculate grid cell key for a given position
+    FCellKey CalculateGridCell(const FVector& Position) const;
+    
+    // Integer coordinates of the cell containing a position
+    FIntVector GetCellCoordinates(const FVector& Position) const;
+    
+    // Build the key of a cell at a hierarchy level (0 is the grid itself)
+    static FCellKey MakeCellKey(const FIntVector& Coordinates, int32 Level = 0);
+    
+    // Decode the coordinates stored in a key
+    static FIntVector GetKeyCoordinates(FCellKey Key);
+    
+    // Squared distance between the centres of the cells containing two positions, so a whole cell shares one LOD tier
+    float GetCellDistanceSquared(const FVector& A, const FVector& B) const;
+    
+    // Add an entity to the spatial grouping system, returns the cell it was placed in
+    FCellKey AddEntity(const FSpatialEntityRef& Ref, const FVector& Position);
+    
+    // Remove an entity from the spatial grouping system
+    void RemoveEntity(const FSpatialEntityRef& Ref, FCellKey GridCell);
+    
+    // Update the position of a tracked entity, migrating it if it crossed into another cell. Returns its cell.
+    FCellKey MoveEntity(const FSpatialEntityRef& Ref, FCellKey GridCell, const FVector& NewPosition);
+    
+    // Find all nearby entities based on position and radius
+    TArray<FSpatialEntityRef> GetNearbyEntities(const FVector& Position, float Radius) const;
+    
+    // Append the nearby entities to a caller-provided buffer, returns the number found.
+    // Does not allocate once the buffer has grown to the usual result size.
+    int32 GetNearbyEntities(const FVector& Position, float Radius, TArray<FSpatialEntityRef>& OutEntities) const;
+    
+    // Answer many radius queries at once, scanning every overlapped cell a single time for all of its queries.
+    // The grid must not change while the lookup runs.
+    void GetNearbyEntities(TArrayView<const FSpatialQuery> Queries, FSpatialQueryResults& OutResults, bool bParallel = true) const;
+    
+    // Append the entities of every occupied cell in an inclusive range of grid coordinates, without distance tests
+    void AppendEntitiesInCellRange(const FIntVector& MinCell, const FIntVector& MaxCell, TArray<FSpatialEntityRef>& OutEntities) const;
+    
+    // Entity references of an occupied cell
+    TArrayView<const FSpatialEntityRef> GetCellRefs(const FGridCell& Cell) const { return TArrayView<const FSpatialEntityRef>(EntryRefs.GetData() + Cell.Start, Cell.Num); }
+    
+    // World origin of a grid cell, which the position lanes are relative to
+    FVector GetCellOrigin(FCellKey Key) const { return FVector(GetKeyCoordinates(Key)) * GridCellSize; }
+    
+    // World position of a pool entry of a cell
+    FVector GetEntryPosition(const FGridCell& Cell, int32 EntryIndex) const
+    {
+        return GetCellOrigin(Cell.Key) + FVector(EntryX[EntryIndex], EntryY[EntryIndex], EntryZ[EntryIndex]);
+    }
+    
+private:
+    // Append zeroed entries to the end of the pool, returns the first one
+    int32 AllocateEntries(int32 Num);
+    
+    // Copy entries within the pool; the ranges must not overlap
+    void CopyEntries(int32 From, int32 To, int32 Num);
+    
+    // Write an entry, storing its position relative to the cell origin
+    void SetEntry(int32 EntryIndex, const FGridCell& Cell, const FSpatialEntityRef& Ref, const FVector& Position);
+    
+    // Pool index of an entity in a cell, or INDEX_NONE
+    int32 FindEntry(const FGridCell& Cell, const FSpatialEntityRef& Ref) const;
+    
+    // Move a full cell to the end of the pool with twice the capacity
+    void GrowCell(FGridCell& Cell);
+    
+    // Repack all cell ranges once most of the pool is unused
+    void CompactPool();
+    
+    // Count an entity in (or out of) the coarse cells above a grid cell
+    void UpdateLevelCounts(const FIntVector& Coordinates, int32 Delta);
+    
+    // Visit the index of every occupied cell overlapping an inclusive range of grid coordinates
+    template<typename TVisitor>
+    void ForEachCellInRange(const FIntVector& MinCell, const FIntVector& MaxCell, TVisitor&& Visitor) const;
+    
+    // Test the entries of a cell against queries 0..NumQueries-1 given by QueryAt, loading each group of four
+    // position lanes once. Calls Emit(Query, PoolIndex) for every entry within a query's radius.
+    template<typename TQueryAt, typename TEmit>
+    void ScanCell(const FGridCell& Cell, int32 NumQueries, TQueryAt&& QueryAt, TEmit&& Emit) const;
+};
+
+template<>
+struct TStructOpsTypeTraits<FSpatialEntityBatch> : public TStructOpsTypeTraitsBase2<FSpatialEntityBatch>
+{
+    enum
+    {
+        WithCopy = false
+    };
+};
+
+/**
+ * Neighbour candidates of grid cells, rebuilt once per frame.
+ * All entities in a cell share one list: the entities of that cell and of the cells directly around it.
+ * Agents standing together therefore discover their neighbours once per cell instead of once per agent.
+ */
+struct ENHANCEDTICK_API FSpatialNeighbourCache
+{
+    // Rebuild the lists of the given cells in a single pass over them; duplicate keys are built once
+    void Build(const FSpatialEntityBatch& Grid, TArrayView<const FSpatialEntityBatch::FCellKey> CellKeys);
     
-    // All objects to be ticked
-    TArray<FTickEntityData> TickEntities;
+    void Reset();
     
-    // Function to trigger ticks for this group
-    TFunction<void(const TArrayView<FTickEntityData>&, float)> BatchTickFunction;
+    // Candidates shared by every entity in a cell, empty if the cell is not cached this frame
+    TArrayView<const FSpatialEntityRef> GetCandidates(FSpatialEntityBatch::FCellKey CellKey) const;
     
-    // Tick group
-    ETickingGroup TickGroup;
+    int32 NumCachedCells() const { return Ranges.Num(); }
     
-    // Average processing time per tick function (in nanoseconds)
-    float AverageTickTimeNs;
+    SIZE_T GetAllocatedSize() const { return Ranges.GetAllocatedSize() + Candidates.GetAllocatedSize(); }
     
-    // Number of entities ticked in the last frame
-    int32 LastFrameTickCount;
+private:
+    struct FCandidateRange
+    {
+        int32 Start;
+        int32 Num;
+    };
     
-    // Whether to use reordering based on cache sorting
-    bool bSortByCacheLocality;
+    // Range of each cached cell in Candidates
+    TMap<FSpatialEntityBatch::FCellKey, FCandidateRange> Ranges;
     
-    FComponentTypeBatch() 
-        : Flags(ETickBatchFlags::None)
-        , BatchLock(MakeShared<FCriticalSection>())
-        , TickGroup(TG_PrePhysics)
-        , AverageTickTimeNs(0.0f)
-        , LastFrameTickCount(0)
-        , bSortByCacheLocality(true)
-    {}
+    // Candidate lists of all cached cells, back to back
+    TArray<FSpatialEntityRef> Candidates;
+};
+
+/**
+ * Pool of objects allocated in fixed-size chunks. Chunks are never reallocated, so an object keeps its address
+ * until the whole pool is reset; objects are only released together, which matches the lifetime of batches.
+ */
+template<typename ElementType, int32 ElementsPerChunk>
+class TEnhancedTickChunkedPool
+{
+public:
+    TEnhancedTickChunkedPool() : NumElements(0) {}
+    ~TEnhancedTickChunkedPool() { Reset(); }
     
-    // Copy constructor - required for use in TMap
-    FComponentTypeBatch(const FComponentTypeBatch& Other)
-        : TypeName(Other.TypeName)
-        , Flags(Other.Flags)
-        , BatchLock(Other.BatchLock ? Other.BatchLock : MakeShared<FCriticalSection>())
-        , TickEntities(Other.TickEntities)
-        , BatchTickFunction(Other.BatchTickFunction)
-        , TickGroup(Other.TickGroup)
-        , AverageTickTimeNs(Other.AverageTickTimeNs)
-        , LastFrameTickCount(Other.LastFrameTickCount)
-        , bSortByCacheLocality(Other.bSortByCacheLocality)
-    {}
+    TEnhancedTickChunkedPool(const TEnhancedTickChunkedPool&) = delete;
+    TEnhancedTickChunkedPool& operator=(const TEnhancedTickChunkedPool&) = delete;
     
-    // Assignment operator - required for use in TMap
-    FComponentTypeBatch& operator=(const FComponentTypeBatch& Other)
+    // Default-construct a new object at a stable address
+    ElementType& Allocate()
     {
-        if (this != &Other)
+        const int32 ChunkIndex = NumElements / ElementsPerChunk;
+        if (ChunkIndex == Chunks.Num())
         {
-            TypeName = Other.TypeName;
-            Flags = Other.Flags;
-            BatchLock = Other.BatchLock ? Other.BatchLock : MakeShared<FCriticalSection>();
-            TickEntities = Other.TickEntities;
-            BatchTickFunction = Other.BatchTickFunction;
-            TickGroup = Other.TickGroup;
-            AverageTickTimeNs = Other.AverageTickTimeNs;
-            LastFrameTickCount = Other.LastFrameTickCount;
-            bSortByCacheLocality = Other.bSortByCacheLocality;
+            Chunks.Add(static_cast<ElementType*>(FMemory::Malloc(sizeof(ElementType) * ElementsPerChunk, alignof(ElementType))));
         }
-        return *this;
+        
+        ElementType* Element = Chunks[ChunkIndex] + NumElements % ElementsPerChunk;
+        ++NumElements;
+        return *new (Element) ElementType();
     }
     
-    // Returns whether the batch supports parallel ticking
-    bool CanTickInParallel() const
+    // Destroy all objects and free the chunks
+    void Reset()
     {
-        return EnumHasAnyFlags(Flags, ETickBatchFlags::UseParallel);
+        for (int32 Index = 0; Index < NumElements; ++Index)
+        {
+            Chunks[Index / ElementsPerChunk][Index % ElementsPerChunk].~ElementType();
+        }
+        for (ElementType* Chunk : Chunks)
+        {
+            FMemory::Free(Chunk);
+        }
+        Chunks.Empty();
+        NumElements = 0;
     }
     
-    // Tick the batch (sequential processing)
-    void TickBatch(float DeltaTime);
+    int32 Num() const { return NumElements; }
     
-    // Tick the batch (parallel processing)
-    void TickBatchParallel(float DeltaTime);
+    // Memory of the chunks themselves, used or not; heap memory owned by the objects is not included
+    SIZE_T GetAllocatedSize() const { return Chunks.Num() * ElementsPerChunk * sizeof(ElementType) + Chunks.GetAllocatedSize(); }
     
-    // Reorder entities based on cache locality
-    void SortForCacheLocality();
+private:
+    TArray<ElementType*> Chunks;
+    int32 NumElements;
 };
 
+class UEnhancedTickSystem;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnEnhancedTickBatchCompleted, TSubclassOf<UObject>, BatchClass);
+
 /**
- * Spatial batch for groups of entities with spatial awareness.
- * Processes nearby entities together using a grid-based approach.
+ * Engine tick function that runs the batches of one tick group inside that group.
+ * Registered with the level's tick task manager, so batches honour their real tick group
+ * and any prerequisites added to it.
  */
 USTRUCT()
-struct ENHANCEDTICK_API FSpatialEntityBatch
+struct ENHANCEDTICK_API FEnhancedTickGroupFunction : public FTickFunction
 {
     GENERATED_BODY()
     
-    // Grid cell size
-    float GridCellSize;
-    
-    // 3D grid structure (X, Y, Z)
-    TMap<uint16, TArray<FTickEntityData*>> GridCells;
-    
-    // All spatial entities
-    TArray<FTickEntityData*> AllSpatialEntities;
+    // Owning tick system
+    UEnhancedTickSystem* System;
     
-    // Lock for thread safety
-    TSharedPtr<FCriticalSection> SpatialLock;
+    // Tick group whose batches this function runs
+    ETickingGroup BatchGroup;
     
-    FSpatialEntityBatch() 
-        : GridCellSize(1000.0f)
-        , SpatialLock(MakeShared<FCriticalSection>())
-    {}
-    
-    // Copy constructor
-    FSpatialEntityBatch(const FSpatialEntityBatch& Other)
-        : GridCellSize(Other.GridCellSize)
-        , GridCells(Other.GridCells)
-        , AllSpatialEntities(Other.AllSpatialEntities)
-        , SpatialLock(Other.SpatialLock ? Other.SpatialLock : MakeShared<FCriticalSection>())
+    FEnhancedTickGroupFunction()
+        : System(nullptr)
+        , BatchGroup(TG_PrePhysics)
     {}
     
-    // Assignment operator
-    FSpatialEntityBatch& operator=(const FSpatialEntityBatch& Other)
+    // FTickFunction interface
+    virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+    virtual FString DiagnosticMessage() override;
+    virtual FName DiagnosticContext(bool bDetailed) override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FEnhancedTickGroupFunction> : public TStructOpsTypeTraitsBase2<FEnhancedTickGroupFunction>
+{
+    enum
     {
-        if (this != &Other)
-        {
-            GridCellSize = Other.GridCellSize;
-            GridCells = Other.GridCells;
-            AllSpatialEntities = Other.AllSpatialEntities;
-            SpatialLock = Other.SpatialLock ? Other.SpatialLock : MakeShared<FCriticalSection>();
-        }
-        return *this;
-    }
-    
-    // Calculate grid cell ID for a given position
-    uint16 CalculateGridCell(const FVector& Position) const;
-    
-    // Add an entity to the spatial grouping system
-    void AddEntity(FTickEntityData* Entity);
-    
-    // Remove an entity from the spatial grouping system
-    void RemoveEntity(FTickEntityData* Entity);
-    
-    // Tick all grid cells (processing nearby ones together)
-    void TickAllGrids(float DeltaTime);
-    
-    // Find all nearby entities based on position and radius
-    TArray<FTickEntityData*> GetNearbyEntities(const FVector& Position, float Radius);
+        WithCopy = false
+    };
 };
 
 /**
@@ -217,7 +1543,7 @@ struct ENHANCEDTICK_API FSpatialEntityBatch
  * Advanced tick mechanism capable of batching both by type and spatial location.
  */
 UCLASS(config=Engine, defaultconfig)
-class ENHANCEDTICK_API UEnhancedTickSystem : public UWorldSubsystem, public FTickableGameObject
+class ENHANCEDTICK_API UEnhancedTickSystem : public UWorldSubsystem
 {
     GENERATED_BODY()
     
@@ -228,15 +1554,12 @@ public:
     virtual void Initialize(FSubsystemCollectionBase& Collection) override;
     virtual void Deinitialize() override;
     
-    // FTickableGameObject interface
-    virtual void Tick(float DeltaTime) override;
-    virtual TStatId GetStatId() const override;
-    virtual ETickableTickType GetTickableTickType() const override { return ETickableTickType::Always; }
-    virtual bool IsTickableWhenPaused() const override { return false; }
-    virtual bool IsTickableInEditor() const override { return false; }
+    // UWorldSubsystem interface
+    virtual void OnWorldBeginPlay(UWorld& InWorld) override;
     
     /**
-     * Registers a single component.
+     * Registers a single component. Safe to call from any thread: the request is queued, and the engine tick of the
+     * component is taken over on the game thread when the request is carried out at the start of the next frame.
      * @param Component - The component to be registered.
      * @param Flags - Tick behavior flags.
      * @param CustomTickTarget - Custom tick target (if null, default tick is used).
@@ -263,31 +1586,271 @@ public:
     UFUNCTION(BlueprintCallable, Category = "Enhanced Tick System")
     void RegisterAllComponentsOfType(TSubclassOf<UActorComponent> ComponentClass, ETickBatchFlags Flags = ETickBatchFlags::None);
     
-    // Unregistration functions
+    /**
+     * Registers many components at once: the requests go to the lock-free registration queue (multi-producer,
+     * single-consumer) and the batches reserve capacity for all of them before they are added.
+     * @param Components - The components to be registered.
+     * @param Flags - Tick behavior flags.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Enhanced Tick System")
+    void RegisterComponents(const TArray<UActorComponent*>& Components, ETickBatchFlags Flags = ETickBatchFlags::None);
+    
+    /**
+     * Registers components of a type as soon as their actor is spawned or streamed in, without scanning the world.
+     * Components that already exist are not touched; use RegisterAllComponentsOfType for them.
+     * @param ComponentClass - The component class to register (subclasses included).
+     * @param Flags - Tick behavior flags.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Enhanced Tick System")
+    void EnableAutoRegistration(TSubclassOf<UActorComponent> ComponentClass, ETickBatchFlags Flags = ETickBatchFlags::None);
+    
+    /**
+     * Stops the automatic registration of a component type.
+     * @param ComponentClass - The class passed to EnableAutoRegistration.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Enhanced Tick System")
+    void DisableAutoRegistration(TSubclassOf<UActorComponent> ComponentClass);
+    
+    /**
+     * Registers a type-specialized batch kernel for objects of exactly class TObject.
+     * The kernel is called as Kernel(TObject&, float DeltaTime) from a generated batch loop.
+     */
+    template<typename TObject, typename TKernel>
+    void RegisterBatchKernel(TKernel&& Kernel)
+    {
+        RegisterBatchTickFunction(TObject::StaticClass(), MakeEnhancedBatchKernel<TObject>(Forward<TKernel>(Kernel)));
+    }
+    
+    /**
+     * Registers a batch kernel for class TObject that calls TObject::TickComponent (or TObject::Tick) directly.
+     */
+    template<typename TObject>
+    void RegisterBatchKernel()
+    {
+        RegisterBatchKernel<TObject>(TEnhancedTickDefaultKernel<TObject>());
+    }
+    
+    /**
+     * Registers a batch tick function for an exact class, replacing the one chosen by the system.
+     * @param Class - The class whose batch should use the function.
+     * @param TickFunction - The batch tick function.
+     */
+    void RegisterBatchTickFunction(UClass* Class, FEnhancedBatchTickFunction&& TickFunction);
+    
+    /**
+     * Registers a two-phase kernel for the batch of class TObject, e.g. for scene components:
+     * RegisterComputeKernel<UMyComponent>([](UMyComponent& C, float Dt, FEnhancedTickCommandBuffer& Commands) { ... });
+     * The kernel runs on worker threads and records its scene writes, which are applied on the game thread.
+     */
+    template<typename TObject, typename TKernel>
+    void RegisterComputeKernel(TKernel&& Kernel)
+    {
+        RegisterBatchComputeFunction(TObject::StaticClass(), MakeEnhancedComputeKernel<TObject>(Forward<TKernel>(Kernel)));
+    }
+    
+    /**
+     * Registers the compute phase of a two-phase batch for an exact class.
+     * @param Class - The class whose batch should tick in two phases.
+     * @param ComputeFunction - The compute function, called from worker threads.
+     */
+    void RegisterBatchComputeFunction(UClass* Class, FEnhancedBatchComputeFunction&& ComputeFunction);
+    
+    // Unregistration functions; like registrations they are queued, and the engine tick is given back as it was
     UFUNCTION(BlueprintCallable, Category = "Enhanced Tick System")
     void UnregisterComponent(UActorComponent* Component);
     
     UFUNCTION(BlueprintCallable, Category = "Enhanced Tick System")
     void UnregisterActor(AActor* Actor, bool bIncludeComponents = true);
     
+    /**
+     * Enables or disables the batched tick of a registered object, applied at the start of the next frame.
+     * Component activation is followed automatically; actors use this in place of SetActorTickEnabled.
+     * @param Object - A registered actor or component.
+     * @param bEnabled - Whether the object should tick.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Enhanced Tick System")
+    void SetEntityTickEnabled(UObject* Object, bool bEnabled);
+    
     // Various helper functions
     UFUNCTION(BlueprintCallable, Category = "Enhanced Tick System")
     void SetDebugMode(bool bEnable, bool bVerbose = false);
     
+    /**
+     * Reads hardware performance counters (cycles, instructions, last level cache misses) around every batch tick
+     * and reports cache misses per entity in the batch statistics. Linux only (perf_event_open); costs a few
+     * microseconds per batch and parallel participant while on. Enabling resets the statistics windows.
+     * @return Whether the counters are on; false if the platform or its permissions do not allow them.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Enhanced Tick System")
+    bool SetHardwareCountersEnabled(bool bEnable);
+    
     UFUNCTION(BlueprintCallable, Category = "Enhanced Tick System")
     void OptimizeBatches();
     
-    // Retrieve profiling data
+    // Retrieve profiling data (per-entity cost of the last tick in nanoseconds)
     UFUNCTION(BlueprintCallable, Category = "Enhanced Tick System")
     TMap<FString, float> GetBatchProfilingData() const;
     
+    /**
+     * Rolling statistics of every batch over its last ticked frames, with the slowest sampled entities.
+     * @return One entry per batch that ticked within the window, highest p95 batch time first.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Enhanced Tick System")
+    TArray<FEnhancedTickBatchStats> GetBatchStats() const;
+    
+    /**
+     * Rolling statistics of the batch for an exact class.
+     * @return False if there is no batch for the class.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Enhanced Tick System")
+    bool GetBatchStatsForClass(TSubclassOf<UObject> Class, FEnhancedTickBatchStats& OutStats) const;
+    
+    // Clear the statistics windows of all batches, e.g. before measuring a scenario
+    UFUNCTION(BlueprintCallable, Category = "Enhanced Tick System")
+    void ResetBatchStats();
+    
     // Retrieve detailed statistical information
     UFUNCTION(BlueprintCallable, Category = "Enhanced Tick System")
     FString GetDetailedStats() const;
+    
+    /**
+     * Creates a lane of plain-data entities ticked by a chunk kernel, or returns the existing lane of that name.
+     * Add the lane's columns right away, before its first element.
+     * @param TickGroup - Group the lane ticks in, after the batches of that group.
+     */
+    FEnhancedTickDataLane& AddDataLane(FName Name, FEnhancedDataLaneKernel&& Kernel, ETickingGroup TickGroup = TG_PrePhysics);
+    
+    FEnhancedTickDataLane* FindDataLane(FName Name);
+    
+    // Only call between frames; lanes tick synchronously within their group
+    void RemoveDataLane(FName Name);
+    
+    /**
+     * Rolling statistics of a data lane; entity costs and counts are per element.
+     * @return False if there is no lane of that name.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Enhanced Tick System")
+    bool GetDataLaneStats(FName Name, FEnhancedTickBatchStats& OutStats) const;
+    
+    /**
+     * Memory held by the tick system, for sizing servers with large populations.
+     * @param OutBatches - Footprint of every batch, largest first.
+     * @return Total bytes: the batches, unused pool slots, the spatial grid, the neighbour cache, the registration map and the data lanes.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Enhanced Tick System")
+    int64 GetMemoryReport(TArray<FEnhancedTickBatchMemory>& OutBatches) const;
+    
+    /**
+     * Sets the scheduling options of the batch for an exact class.
+     * @param Class - Class of the batched components or actors.
+     * @param Settings - Options, applied to the existing batch as well as to one created later.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Enhanced Tick System")
+    void SetBatchSettings(TSubclassOf<UObject> Class, const FEnhancedTickBatchSettings& Settings);
+    
+    UFUNCTION(BlueprintCallable, Category = "Enhanced Tick System")
+    FEnhancedTickBatchSettings GetBatchSettings(TSubclassOf<UObject> Class) const;
+    
+    /**
+     * Declares that the batch of After must not start before the batch of Before has finished.
+     * Parallel batches of a tick group with declared dependencies are scheduled as a graph on worker threads,
+     * so independent ones run concurrently.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Enhanced Tick System")
+    void AddBatchDependency(TSubclassOf<UObject> Before, TSubclassOf<UObject> After);
+    
+    /**
+     * Returns whether the asynchronous tick of a batch has been joined (or none is in flight).
+     */
+    UFUNCTION(BlueprintCallable, Category = "Enhanced Tick System")
+    bool IsBatchTickComplete(TSubclassOf<UObject> Class) const;
+    
+    /**
+     * Returns the completion event of a batch's in-flight asynchronous tick, or null if none is pending.
+     * Can be used as a prerequisite for task graph work that consumes the batch results.
+     */
+    FGraphEventRef GetBatchCompletionEvent(UClass* Class) const;
+    
+    /**
+     * Joins the asynchronous tick of a batch right away instead of at its join group.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Enhanced Tick System")
+    void WaitForBatch(TSubclassOf<UObject> Class);
+    
+    // Broadcast on the game thread when an asynchronous batch has been joined
+    UPROPERTY(BlueprintAssignable, Category = "Enhanced Tick System")
+    FOnEnhancedTickBatchCompleted OnBatchCompleted;
+    
+    /**
+     * Sets the layout of the spatial grid. Only applies while no spatially aware entity is registered.
+     * @param CellSize - Edge length of a grid cell in world units.
+     * @param HierarchyLevels - Coarse occupancy levels above the grid, for large worlds with uneven density (0 for a flat grid).
+     */
+    UFUNCTION(BlueprintCallable, Category = "Enhanced Tick System")
+    void ConfigureSpatialGrid(float CellSize, int32 HierarchyLevels = 0);
+    
+    /**
+     * Caps the time all batches may take per frame. Once the budget is used up, the remaining entities of
+     * batches that are not HighPrio carry over, longest waiting first, with their accumulated delta time.
+     * @param Milliseconds - Budget per frame, 0 to disable.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Enhanced Tick System")
+    void SetFrameBudget(float Milliseconds);
+    
+    /**
+     * Caps the time the batches of one tick group may take per frame, in addition to the frame budget.
+     * @param Group - Tick group (TG_PrePhysics to TG_LastDemotable).
+     * @param Milliseconds - Budget per frame, 0 to disable.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Enhanced Tick System")
+    void SetTickGroupBudget(TEnumAsByte<ETickingGroup> Group, float Milliseconds);
+    
+    /**
+     * Returns the engine tick function that runs the batches of a tick group.
+     * Use it to add prerequisites, e.g. GetGroupTickFunction(TG_PrePhysics)->AddPrerequisite(Actor, Actor->PrimaryActorTick).
+     * @param Group - Tick group (TG_PrePhysics to TG_LastDemotable).
+     */
+    FTickFunction* GetGroupTickFunction(ETickingGroup Group);
+    
+    /**
+     * Returns the neighbour candidates shared by the entities in the grid cell containing a position, as built
+     * this frame for batches that use the neighbour cache (AI perception). Candidates still need a distance test.
+     */
+    TArrayView<const FSpatialEntityRef> GetNeighbourCandidates(const FVector& Position) const;
 
 private:
-    // Batches based on component type
-    TMap<UClass*, FComponentTypeBatch> TypeBatches;
+    friend struct FEnhancedTickGroupFunction;
+    
+    // One engine tick function per tick group, indexed by ETickingGroup
+    FEnhancedTickGroupFunction GroupTickFunctions[TG_NewlySpawned];
+    
+    // Register the tick function of a group with the world's persistent level (once it began play)
+    void RegisterGroupTickFunction(ETickingGroup Group);
+    
+    // Register the high priority tick function that joins the batches of deferred-join settings
+    void RegisterJoinTickFunction(const FEnhancedTickBatchSettings& Settings);
+    
+    // Called by the group tick functions from inside the engine tick groups
+    void ExecuteGroupTick(ETickingGroup Group, float DeltaTime);
+    
+    // Per-frame housekeeping run before the first batch of the frame
+    void BeginFrame(float DeltaTime);
+    
+    // Work after the last batch of the frame, from the TG_LastDemotable group function
+    void EndFrame(float DeltaTime);
+    
+    // Batches based on component type. The batches themselves live in BatchPool, so pointers to them
+    // (GroupedBatches, tick states) stay valid while the map grows.
+    TMap<UClass*, FComponentTypeBatch*> TypeBatches;
+    
+    // Storage of all batches of this world, released in one go on Deinitialize
+    TEnhancedTickChunkedPool<FComponentTypeBatch, 16> BatchPool;
+    
+    // Batch of a class, created in the pool on first use
+    FComponentTypeBatch& FindOrAddBatch(UClass* Class);
+    
+    // Plain-data lanes by name; they tick after the batches of their group
+    TMap<FName, TUniquePtr<FEnhancedTickDataLane>> DataLanes;
     
     // Spatial batches
     FSpatialEntityBatch SpatialBatch;
@@ -295,15 +1858,143 @@ private:
     // Batches sorted by tick groups
     TMap<ETickingGroup, TArray<FComponentTypeBatch*>> GroupedBatches;
     
-    // Critical section lock
-    TSharedPtr<FCriticalSection> BatchesLock;
+    // Request queued by any thread; the game thread drains the queue once per frame
+    struct FDeferredOperation
+    {
+        enum class EType : uint8
+        {
+            Register,
+            Unregister,
+            SetEnabled
+        };
+        
+        EType Type;
+        UObject* Object;
+        ETickBatchFlags Flags;
+        UObject* CustomTickTarget;
+        FName CustomTickFunction;
+        bool bEnabled; // New state for SetEnabled; for Unregister, whether the native tick is given back
+        
+        FDeferredOperation()
+            : Type(EType::Register), Object(nullptr), Flags(ETickBatchFlags::None), CustomTickTarget(nullptr), bEnabled(true)
+        {}
+    };
+    
+    // Lock-free multi-producer single-consumer queue of all deferred operations, in submission order
+    TQueue<FDeferredOperation, EQueueMode::Mpsc> DeferredOperations;
+    
+    // Queue a deferred operation (any thread)
+    void QueueRegistration(UObject* Object, ETickBatchFlags Flags, UObject* CustomTickTarget = nullptr, FName CustomTickFunction = NAME_None);
+    void QueueUnregistration(UObject* Object, bool bRestoreNativeTick = true);
+    
+    // Deferred registration request, as drained from the queue
+    struct FPendingRegistration
+    {
+        UObject* Object;
+        ETickBatchFlags Flags;
+        UObject* CustomTickTarget;
+        FName CustomTickFunction;
+        uint32 Serial;
+        
+        FPendingRegistration(uint32 InSerial, UObject* InObject, ETickBatchFlags InFlags, UObject* InCustomTickTarget = nullptr, FName InCustomTickFunction = NAME_None)
+            : Object(InObject), Flags(InFlags), CustomTickTarget(InCustomTickTarget), CustomTickFunction(InCustomTickFunction), Serial(InSerial)
+        {}
+    };
+    
+    // Deferred unregistration request
+    struct FPendingUnregistration
+    {
+        UObject* Object;
+        uint32 Serial;
+        bool bRestoreNativeTick; // False for removals at end of play, whose engine tick is going away anyway
+        
+        FPendingUnregistration(uint32 InSerial, UObject* InObject, bool bInRestoreNativeTick)
+            : Object(InObject), Serial(InSerial), bRestoreNativeTick(bInRestoreNativeTick)
+        {}
+    };
+    
+    // Requests drained this frame (game thread only)
+    TArray<FPendingRegistration> PendingRegistrations;
+    TArray<FPendingUnregistration> PendingUnregistrations;
+    
+    // Order of the queued requests across both queues; only the last request for an object is carried out
+    uint32 NextRequestSerial;
+    
+    // Batch and handle of every registered object, so unregistration never searches the batches
+    TMap<UObject*, FSpatialEntityRef> RegisteredEntities;
+    
+    // Engine tick state of a registered object before it was taken over
+    struct FNativeTickState
+    {
+        bool bCanEverTick;      // Components: the flag cleared on take over
+        bool bTickRegistered;   // Components: the tick function was registered with the level
+        bool bTickEnabled;      // The tick was enabled and is turned off while the object is batched
+    };
+    
+    // Native tick state of every registered object, put back when it is unregistered (game thread only)
+    TMap<UObject*, FNativeTickState> NativeTickStates;
+    
+    // Enable state changes drained this frame, applied with the other deferred operations
+    TArray<TPair<UObject*, bool>> PendingEnableChanges;
+    
+    // Queue an enable state change of a registered object (any thread)
+    void QueueEnableChange(UObject* Object, bool bEnabled);
+    
+    // Follow activation and end of play of a registered object instead of polling it every frame
+    void BindLifetimeEvents(UObject* Object);
+    void UnbindLifetimeEvents(UObject* Object);
+    
+    // Take over and give back the engine tick of a registered object, from the deferred operations (game thread)
+    void DisableNativeTick(UObject* Object);
+    void RestoreNativeTick(UObject* Object);
+    
+    UFUNCTION()
+    void HandleComponentActivated(UActorComponent* Component, bool bReset);
+    
+    UFUNCTION()
+    void HandleComponentDeactivated(UActorComponent* Component);
+    
+    // Unregisters the actor and its registered components once it leaves play
+    UFUNCTION()
+    void HandleActorEndPlay(AActor* Actor, EEndPlayReason::Type EndPlayReason);
+    
+    UFUNCTION()
+    void HandleActorDestroyed(AActor* Actor);
+    
+    // Frame counter for low priority ticks, LOD phases and periodic work
+    uint64 FrameCounter;
+    
+    // Viewers and time of the current frame, read by batches with tick LOD
+    FEnhancedTickLODFrame LODFrame;
+    
+    // Advance the LOD time and gather the local player view locations
+    void UpdateLODFrame(float DeltaTime);
+    
+    // Gather the current entity positions and migrate the entities that crossed grid cells
+    void RefreshEntityPositions();
+    
+    // Shared neighbour candidates of the cells occupied by batches that use them
+    FSpatialNeighbourCache NeighbourCache;
     
-    // Queues for deferred registration and unregistration
-    TArray<TPair<UObject*, ETickBatchFlags>> PendingRegistrations;
-    TArray<UObject*> PendingUnregistrations;
+    // Scratch list of the cells to cache this frame
+    TArray<FSpatialEntityBatch::FCellKey> NeighbourCacheCells;
+    
+    // Rebuild the neighbour cache from the refreshed grid
+    void UpdateNeighbourCache();
+    
+    // Frame budget in cycles (0 for none) and the part of it used so far this frame
+    uint64 FrameBudgetCycles;
+    uint64 FrameBudgetCyclesUsed;
+    
+    // Budget per tick group in cycles (0 for none)
+    uint64 GroupBudgetCycles[TG_NewlySpawned];
+    
+    // Cycles left in the frame and group budgets, MAX_int64 without a budget
+    int64 GetRemainingBudgetCycles(ETickingGroup Group, uint64 GroupCyclesUsed) const;
+    
+    // Number of entities of a batch that fit into the remaining cycles, INDEX_NONE for no limit
+    static int32 EstimateBudgetEntities(const FComponentTypeBatch& Batch, int64 RemainingCycles);
     
-    // Frame counter for low priority ticks
-    int32 FrameCounter;
     
     // Debug mode flags
     bool bDebugMode;
@@ -315,8 +2006,57 @@ private:
     // Apply optimization hints for tick functions
     void ApplyOptimizationHints();
     
+    // Scheduling options per exact class
+    TMap<UClass*, FEnhancedTickBatchSettings> BatchSettings;
+    
+    // Component types registered automatically, with their flags
+    TMap<TSubclassOf<UActorComponent>, ETickBatchFlags> AutoRegisteredClasses;
+    
+    // World hooks used for automatic registration (bound while AutoRegisteredClasses is not empty)
+    FDelegateHandle ActorSpawnedHandle;
+    FDelegateHandle LevelAddedHandle;
+    
+    // Add the hooks on first use, remove them when no class is left
+    void UpdateAutoRegistrationHooks();
+    
+    // Queue the auto-registered components of actors
+    void AutoRegisterActorComponents(TArrayView<AActor* const> Actors);
+    
+    void HandleActorSpawned(AActor* Actor);
+    void HandleLevelAddedToWorld(ULevel* Level, UWorld* World);
+    
+    // Batches dispatched asynchronously and not joined yet
+    TArray<FComponentTypeBatch*> InFlightAsyncBatches;
+    
+    // Join the in-flight batches whose join group is at or before the given group
+    void JoinAsyncBatches(ETickingGroup Group);
+    
+    // Finish one in-flight batch: wait, record its profile and notify listeners
+    void CompleteAsyncBatch(FComponentTypeBatch& Batch);
+    
+    // Tick batches with declared dependencies as a task graph, independent ones concurrently
+    void TickBatchGraph(TArrayView<FComponentTypeBatch* const> Nodes, float DeltaTime);
+    
+    // Batch kernels registered through RegisterBatchKernel, keyed by exact class
+    TMap<UClass*, FEnhancedBatchTickFunction> RegisteredBatchKernels;
+    
+    // Compute kernels registered through RegisterComputeKernel, keyed by exact class
+    TMap<UClass*, FEnhancedBatchComputeFunction> RegisteredComputeKernels;
+    
+    // Thread safety classification per class, computed on first use
+    TMap<UClass*, bool> GameThreadOnlyClasses;
+    
+    // Whether ticks of the class touch scene state that may only be written on the game thread
+    bool IsGameThreadOnlyClass(UClass* Class);
+    
     // Determine the best tick function for a batch based on the component class
-    TFunction<void(const TArrayView<FTickEntityData>&, float)> DetermineBestTickFunction(UClass* Class);
+    FEnhancedBatchTickFunction DetermineBestTickFunction(UClass* Class);
+    
+    // Fallback tick function that honours per-entity custom tick functions
+    FEnhancedBatchTickFunction MakePerEntityTickFunction(UClass* Class);
+    
+    // Build the per-entity tick function that invokes a UFunction on a custom target
+    static TFunction<void(float)> MakeCustomTickFunction(UObject* Target, FName FunctionName);
     
     // Execute batches based on tick groups
     void TickGroupBatches(ETickingGroup Group, float DeltaTime);
@@ -324,21 +2064,21 @@ private:
     // Process deferred operations
     void ProcessDeferredOperations();
     
-    // Internal deferred operations processing (called within a lock)
+    // Internal deferred operations processing (game thread, on the drained requests)
     void ProcessDeferredOperationsImpl();
     
     // Helper function for batch profiling
-    void UpdateBatchProfilingData(FComponentTypeBatch& Batch, float ExecutionTimeMs);
-    
-    // Check conditional tick objects
-    void UpdateConditionalTicks();
+    void UpdateBatchProfilingData(FComponentTypeBatch& Batch);
     
     // AI optimization helpers for specialized component types
     void OptimizeCharacterMovementBatch(FComponentTypeBatch& Batch);
     void OptimizeAIPerceptionBatch(FComponentTypeBatch& Batch);
     
+    // Set SpatialAware on a batch and add its current entities to the spatial grid
+    void EnableSpatialAwareness(FComponentTypeBatch& Batch);
+    
     // Calculate the appropriate spatial grid for an entity in a batch
-    uint16 CalculateSpatialBucketId(const FVector& Position);
+    uint64 CalculateSpatialBucketId(const FVector& Position);
     
     // Sort batches by priority
     void SortBatchesByPriority();
@@ -347,19 +2087,52 @@ private:
     struct FTickStats
     {
         int32 TotalRegisteredEntities;
-        int32 ActiveEntities;
         int32 ParallelBatchCount;
         int32 SpatialBatchCount;
+        
+        // Totals of the last completed frame
+        int32 ActiveEntities;
         float TotalTickTimeMs;
-        int32 CacheMissCount;
+        int32 BudgetDeferredEntities;
+        int32 CosmeticSkippedEntities;
+        uint64 CacheMissCount;
+        
+        // Totals of the frame in progress
+        int32 FrameActiveEntities;
+        float FrameTickTimeMs;
+        int32 FrameBudgetDeferredEntities;
+        int32 FrameCosmeticSkippedEntities;
+        uint64 FrameCacheMissCount;
         
         FTickStats() 
           : TotalRegisteredEntities(0)
-          , ActiveEntities(0)
           , ParallelBatchCount(0)
           , SpatialBatchCount(0)
+          , ActiveEntities(0)
           , TotalTickTimeMs(0.0f)
+          , BudgetDeferredEntities(0)
+          , CosmeticSkippedEntities(0)
           , CacheMissCount(0)
+          , FrameActiveEntities(0)
+          , FrameTickTimeMs(0.0f)
+          , FrameBudgetDeferredEntities(0)
+          , FrameCosmeticSkippedEntities(0)
+          , FrameCacheMissCount(0)
         {}
+        
+        // Publish the totals of the frame in progress and start the next one
+        void CompleteFrame()
+        {
+            ActiveEntities = FrameActiveEntities;
+            TotalTickTimeMs = FrameTickTimeMs;
+            BudgetDeferredEntities = FrameBudgetDeferredEntities;
+            CosmeticSkippedEntities = FrameCosmeticSkippedEntities;
+            CacheMissCount = FrameCacheMissCount;
+            FrameActiveEntities = 0;
+            FrameTickTimeMs = 0.0f;
+            FrameBudgetDeferredEntities = 0;
+            FrameCosmeticSkippedEntities = 0;
+            FrameCacheMissCount = 0;
+        }
     } Stats;
 };